@@ -0,0 +1,245 @@
+// Result files shared by the sobj benchmarks. Every file and stage keeps all of its samples,
+// so two result files can be compared with sobj_bench --compare.
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+constexpr int RESULT_VERSION = 1;
+
+/// @brief All wall time samples of one stage of one file.
+struct Result {
+    std::string file{};
+    std::string stage{};
+    size_t bytes = 0;
+    std::vector<double> wallSeconds{};
+    std::vector<double> cpuSeconds{};
+};
+
+inline double median(std::vector<double> values)
+{
+    if (values.empty()) return 0.0;
+    std::ranges::sort(values);
+    const size_t middle = values.size() / 2;
+    if (values.size() % 2 == 1) return values[middle];
+    return (values[middle - 1] + values[middle]) / 2.0;
+}
+
+/// @brief Median absolute deviation, a spread estimate that ignores a few outlier runs.
+inline double mad(const std::vector<double>& values)
+{
+    const double center = median(values);
+    std::vector<double> deviations{};
+    for (const double value : values) {
+        deviations.push_back(std::abs(value - center));
+    }
+    return median(std::move(deviations));
+}
+
+inline std::string jsonString(const std::string_view text)
+{
+    std::string result{ "\"" };
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            result += std::format("\\u{:04x}", c);
+        } else {
+            result += c;
+        }
+    }
+    return result + '"';
+}
+
+/// @brief Just enough of a json reader for the files writeResults produces.
+class JsonReader
+{
+public:
+    explicit JsonReader(std::string text) : m_text(std::move(text))
+    {
+    }
+
+    /// @brief Skips whitespace and tells whether c comes next.
+    bool peek(const char c)
+    {
+        while (m_position < m_text.size() &&
+               std::isspace(static_cast<unsigned char>(m_text[m_position]))) {
+            m_position++;
+        }
+        return m_position < m_text.size() && m_text[m_position] == c;
+    }
+
+    /// @brief Consumes c if it comes next.
+    bool consume(const char c)
+    {
+        if (!peek(c)) return false;
+        m_position++;
+        return true;
+    }
+
+    std::optional<std::string> string()
+    {
+        if (!consume('"')) return std::nullopt;
+        std::string result{};
+        while (m_position < m_text.size() && m_text[m_position] != '"') {
+            char c = m_text[m_position++];
+            if (c == '\\' && m_position < m_text.size()) {
+                c = m_text[m_position++];
+                if (c == 'u' && m_position + 4 <= m_text.size()) {
+                    c = static_cast<char>(std::strtol(m_text.substr(m_position, 4).c_str(),
+                                                      nullptr, 16));
+                    m_position += 4;
+                }
+            }
+            result += c;
+        }
+        if (!consume('"')) return std::nullopt;
+        return result;
+    }
+
+    std::optional<double> number()
+    {
+        peek(' ');
+        double value            = 0.0;
+        const char* begin       = m_text.data() + m_position;
+        const auto [ptr, error] = std::from_chars(begin, m_text.data() + m_text.size(), value);
+        if (error != std::errc{}) return std::nullopt;
+        m_position = static_cast<size_t>(ptr - m_text.data());
+        return value;
+    }
+
+    std::optional<std::vector<double>> numbers()
+    {
+        if (!consume('[')) return std::nullopt;
+        std::vector<double> values{};
+        if (consume(']')) return values;
+        do {
+            const auto value = number();
+            if (!value) return std::nullopt;
+            values.push_back(*value);
+        } while (consume(','));
+        if (!consume(']')) return std::nullopt;
+        return values;
+    }
+
+    /// @brief Calls member with every key of an object, which has to consume the value.
+    bool object(const std::function<bool(const std::string&)>& member)
+    {
+        if (!consume('{')) return false;
+        if (consume('}')) return true;
+        do {
+            const auto key = string();
+            if (!key || !consume(':') || !member(*key)) return false;
+        } while (consume(','));
+        return consume('}');
+    }
+
+    bool skipValue()
+    {
+        if (consume('[')) {
+            if (consume(']')) return true;
+            do {
+                if (!skipValue()) return false;
+            } while (consume(','));
+            return consume(']');
+        }
+        if (peek('{')) return object([this](const std::string&) { return skipValue(); });
+        if (string() || number()) return true;
+        for (const std::string_view literal : { "true", "false", "null" }) {
+            if (m_text.compare(m_position, literal.size(), literal) == 0) {
+                m_position += literal.size();
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::string m_text{};
+    size_t m_position = 0;
+};
+
+inline bool writeResults(const std::string& filePath, const size_t iterations, const bool cold,
+                  const std::vector<Result>& results)
+{
+    std::ofstream file{ filePath };
+    if (!file.is_open()) return false;
+
+    const auto list = [](const std::vector<double>& values) {
+        std::string text{};
+        for (const double value : values) {
+            text += std::format("{}{:.9g}", text.empty() ? "" : ",", value);
+        }
+        return "[" + text + "]";
+    };
+
+    file << std::format("{{\"version\":{},\"iterations\":{},\"cold\":{},\"results\":[",
+                        RESULT_VERSION,
+                        iterations,
+                        cold);
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        file << std::format("{}\n{{\"file\":{},\"stage\":{},\"bytes\":{},\"median\":{:.9g},"
+                            "\"mad\":{:.9g},\"wall\":{},\"cpu\":{}}}",
+                            i == 0 ? "" : ",",
+                            jsonString(result.file),
+                            jsonString(result.stage),
+                            result.bytes,
+                            median(result.wallSeconds),
+                            mad(result.wallSeconds),
+                            list(result.wallSeconds),
+                            list(result.cpuSeconds));
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+inline std::optional<std::vector<Result>> readResults(const std::string& filePath)
+{
+    std::ifstream file{ filePath };
+    if (!file.is_open()) return std::nullopt;
+    JsonReader reader{ std::string{ std::istreambuf_iterator<char>{ file }, {} } };
+
+    std::vector<Result> results{};
+    const auto readResult = [&](const std::string& key) {
+        Result& result = results.back();
+        if (key == "file" || key == "stage") {
+            const auto value = reader.string();
+            if (value) (key == "file" ? result.file : result.stage) = *value;
+            return value.has_value();
+        }
+        if (key == "wall" || key == "cpu") {
+            auto values = reader.numbers();
+            if (values) (key == "wall" ? result.wallSeconds : result.cpuSeconds) = *values;
+            return values.has_value();
+        }
+        return reader.skipValue();
+    };
+
+    const bool valid = reader.object([&](const std::string& key) {
+        if (key != "results") return reader.skipValue();
+        if (!reader.consume('[')) return false;
+        if (reader.consume(']')) return true;
+        do {
+            results.emplace_back();
+            if (!reader.object(readResult)) return false;
+        } while (reader.consume(','));
+        return reader.consume(']');
+    });
+    if (!valid) return std::nullopt;
+    return results;
+}
+} // namespace bench
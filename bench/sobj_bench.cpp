@@ -0,0 +1,813 @@
+// Load benchmark for sobj.
+//
+// Reads each obj file together with its material libraries and textures through several
+// read backends and through OBJLoader itself. With --cold every input file is evicted from
+// the page cache before each iteration, so the numbers show what a fresh node sees.
+// Everything runs on the calling thread, which makes wall time minus thread cpu time the
+// time spent waiting on I/O. The load backend is also broken down into the stages sobj
+// traces, such as OBJLoader::open and OBJLoader::shrink. Those may run on other threads, so
+// only their wall time is known.
+//
+// Build with the same include paths as any other sobj user, for example
+//     c++ -std=c++23 -O2 -I.. sobj_bench.cpp -o sobj_bench -pthread
+// and add -DSOBJ_BENCH_IO_URING -luring to enable the io_uring backend.
+//
+// Usage: sobj_bench [--cold] [--iterations N] [--backend NAME] [--json FILE] file.obj...
+//        sobj_bench --scaling [--threads N] [--iterations N] [--json FILE] file.obj...
+//        sobj_bench --compare BASELINE.json CANDIDATE.json
+// NAME is one of ifstream, mmap, pread, io_uring, load or all (default). --json writes every
+// sample per file and stage. --compare diffs the wall time medians of two such files and
+// calls a change significant once it exceeds SIGNIFICANCE standard errors, estimated from the
+// median absolute deviation of the runs. Stages with fewer than MIN_COMPARE_SAMPLES runs on
+// either side are not judged, and stages missing from the candidate are listed as missing.
+// It exits with 2 if anything got significantly slower.
+//
+// --scaling runs every parallel feature of sobj at 1, 2, 4 ... N threads (all hardware
+// threads by default) instead: loads, which decode textures and convert ply elements in
+// parallel, many loads at once, texture decode on its own and the post-processing functions.
+// It reports speedup and parallel efficiency against one thread, and flags efficiencies below
+// LOW_EFFICIENCY, which usually means a serial bottleneck. Cpu time is that of the whole
+// process, so cpu ms growing with the thread count is time lost to waiting and contention.
+// Counts above the hardware threads oversubscribe the cores. Bandwidth counts the bytes read
+// from disk plus the bytes of the data read and written in memory, so it is a lower bound of
+// the memory traffic. Files ending in .ply are loaded with PLYLoader.
+
+#define SOBJ_IMPLEMENTATION
+#include "../sobj.hpp"
+#include "bench_results.hpp"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <map>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef SOBJ_BENCH_IO_URING
+#include <liburing.h>
+#endif
+
+namespace
+{
+using namespace bench;
+
+//--------------------------------------------------
+// MARK: Constants
+//--------------------------------------------------
+
+constexpr size_t CHUNK_SIZE         = 1 << 20;
+constexpr size_t PAGE_SIZE          = 4096;
+constexpr unsigned IO_URING_DEPTH   = 8;
+constexpr size_t DEFAULT_ITERATIONS = 5;
+// scales the median absolute deviation of normal data to its standard deviation
+constexpr double MAD_TO_SIGMA = 1.4826;
+// standard error of the median relative to that of the mean for normal data
+constexpr double MEDIAN_ERROR   = 1.2533;
+constexpr double SIGNIFICANCE   = 3.0;
+// below this the median absolute deviation is too often 0 to estimate the error from
+constexpr size_t MIN_COMPARE_SAMPLES = 5;
+constexpr double LOW_EFFICIENCY = 0.5;
+// concurrent loads per thread of the largest thread count in the batch load feature
+constexpr size_t BATCH_LOADS_PER_THREAD = 2;
+// enough rays to keep the bake busy without dominating the whole run
+constexpr uint32_t SCALING_AO_RAYS = 8;
+
+//--------------------------------------------------
+// MARK: Data Classes
+//--------------------------------------------------
+
+struct Options {
+    bool cold         = false;
+    size_t iterations = DEFAULT_ITERATIONS;
+    std::string backend{ "all" };
+    std::vector<std::string> filePaths{};
+    std::string jsonPath{};
+    // baseline and candidate result files, benchmarks are not run if set
+    std::optional<std::pair<std::string, std::string>> compare = std::nullopt;
+    bool scaling      = false;
+    size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+};
+
+struct Sample {
+    double wallSeconds = 0.0;
+    double cpuSeconds  = 0.0;
+    size_t bytes       = 0;
+};
+
+using Backend = std::function<size_t(const std::vector<std::string>&)>;
+
+/// @brief Parallel work of sobj run on the given executor, returns the bytes it moved.
+struct Feature {
+    std::string name{};
+    std::function<size_t(const std::shared_ptr<sobj::Executor>&)> run{};
+};
+
+/// @brief Runs everything on the submitting thread so loads stay single threaded.
+class InlineExecutor final : public sobj::Executor
+{
+public:
+    void submit(std::function<void()> task) override
+    {
+        task();
+    }
+
+    void wait() override
+    {
+    }
+
+    size_t concurrency() const override
+    {
+        return 1;
+    }
+};
+
+//--------------------------------------------------
+// MARK: Utilities
+//--------------------------------------------------
+
+double threadCPUSeconds()
+{
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+}
+
+/// @brief User and system time of all threads of the process.
+double processCPUSeconds()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    const auto seconds = [](const timeval& time) {
+        return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) * 1e-6;
+    };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+size_t fileSize(const int fd)
+{
+    struct stat info{};
+    if (fstat(fd, &info) != 0) return 0;
+    return static_cast<size_t>(info.st_size);
+}
+
+size_t filesSize(const std::vector<std::string>& files)
+{
+    size_t bytes = 0;
+    for (const auto& path : files) {
+        bytes += std::filesystem::file_size(path);
+    }
+    return bytes;
+}
+
+/// @brief Drops the cached pages of every file. Dirty or mapped pages stay cached.
+void evict(const std::vector<std::string>& files)
+{
+    for (const auto& file : files) {
+        const int fd = open(file.c_str(), O_RDONLY);
+        if (fd < 0) continue;
+        if (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) != 0) {
+            std::fprintf(stderr, "warning: could not evict %s from the page cache\n", file.c_str());
+        }
+        close(fd);
+    }
+}
+
+/// @brief The obj file, its material libraries and the textures they reference.
+std::optional<std::vector<std::string>> inputFiles(const std::string& filePath)
+{
+    if (filePath.ends_with(".ply")) {
+        if (!std::filesystem::exists(filePath)) return std::nullopt;
+        return std::vector{ filePath };
+    }
+
+    sobj::OBJLoader loader;
+    const auto summary = loader.scan(filePath);
+    if (!summary) return std::nullopt;
+
+    const auto directory = std::filesystem::path{ filePath }.parent_path();
+    std::vector<std::string> files{ filePath };
+    for (const auto& names : { summary->materialLibraries, summary->textures }) {
+        for (const auto& name : names) {
+            const auto path = directory / name;
+            if (std::filesystem::exists(path)) {
+                files.push_back(path.string());
+            } else {
+                std::fprintf(stderr, "warning: skipping missing file %s\n", path.c_str());
+            }
+        }
+    }
+    return files;
+}
+
+//--------------------------------------------------
+// MARK: Backends
+//--------------------------------------------------
+
+size_t readIfstream(const std::vector<std::string>& files)
+{
+    size_t bytes = 0;
+    std::vector<char> buffer(CHUNK_SIZE);
+    for (const auto& path : files) {
+        std::ifstream file{ path, std::ios::binary };
+        while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
+               file.gcount() > 0) {
+            bytes += static_cast<size_t>(file.gcount());
+        }
+    }
+    return bytes;
+}
+
+size_t readMmap(const std::vector<std::string>& files)
+{
+    size_t bytes = 0;
+    for (const auto& path : files) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) continue;
+        const size_t size = fileSize(fd);
+        if (size == 0) {
+            close(fd);
+            continue;
+        }
+
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) continue;
+        madvise(mapping, size, MADV_SEQUENTIAL);
+
+        // touch every page so the whole file is faulted in
+        const auto* data = static_cast<const volatile char*>(mapping);
+        char sum         = 0;
+        for (size_t i = 0; i < size; i += PAGE_SIZE) {
+            sum = static_cast<char>(sum + data[i]);
+        }
+        static_cast<void>(sum);
+        munmap(mapping, size);
+        bytes += size;
+    }
+    return bytes;
+}
+
+size_t readPread(const std::vector<std::string>& files)
+{
+    size_t bytes = 0;
+    std::vector<char> buffer(CHUNK_SIZE);
+    for (const auto& path : files) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) continue;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        off_t offset = 0;
+        ssize_t read = 0;
+        while ((read = pread(fd, buffer.data(), buffer.size(), offset)) > 0) {
+            offset += read;
+        }
+        close(fd);
+        bytes += static_cast<size_t>(offset);
+    }
+    return bytes;
+}
+
+#ifdef SOBJ_BENCH_IO_URING
+/// @brief Keeps IO_URING_DEPTH chunk reads of a file in flight at once.
+size_t readIoUring(const std::vector<std::string>& files)
+{
+    io_uring ring{};
+    if (io_uring_queue_init(IO_URING_DEPTH, &ring, 0) != 0) return 0;
+
+    size_t bytes = 0;
+    std::vector<std::vector<char>> buffers(IO_URING_DEPTH, std::vector<char>(CHUNK_SIZE));
+    for (const auto& path : files) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) continue;
+        const size_t size = fileSize(fd);
+
+        // reads complete in any order, so each one carries the buffer it is using
+        std::vector<uint64_t> freeBuffers{};
+        for (uint64_t i = 0; i < IO_URING_DEPTH; i++) {
+            freeBuffers.push_back(i);
+        }
+
+        size_t submitted = 0;
+        while (submitted < size || freeBuffers.size() < IO_URING_DEPTH) {
+            while (submitted < size && !freeBuffers.empty()) {
+                const uint64_t buffer = freeBuffers.back();
+                freeBuffers.pop_back();
+
+                io_uring_sqe* sqe  = io_uring_get_sqe(&ring);
+                const size_t chunk = std::min(CHUNK_SIZE, size - submitted);
+                io_uring_prep_read(sqe, fd, buffers[buffer].data(), chunk, submitted);
+                io_uring_sqe_set_data64(sqe, buffer);
+                submitted += chunk;
+            }
+            io_uring_submit(&ring);
+
+            io_uring_cqe* cqe = nullptr;
+            if (io_uring_wait_cqe(&ring, &cqe) != 0) break;
+            if (cqe->res > 0) bytes += static_cast<size_t>(cqe->res);
+            freeBuffers.push_back(io_uring_cqe_get_data64(cqe));
+            io_uring_cqe_seen(&ring, cqe);
+        }
+        close(fd);
+    }
+
+    io_uring_queue_exit(&ring);
+    return bytes;
+}
+#endif
+
+std::optional<sobj::OBJData> loadData(const std::string& filePath,
+                                      const std::shared_ptr<sobj::Executor>& executor)
+{
+    if (filePath.ends_with(".ply")) {
+        sobj::PLYLoader loader;
+        loader.setExecutor(executor);
+        if (!loader.load(filePath)) return std::nullopt;
+        return loader.steal();
+    }
+
+    sobj::OBJLoader loader;
+    loader.setExecutor(executor);
+    if (!loader.load(filePath)) return std::nullopt;
+    return loader.steal();
+}
+
+size_t load(const std::vector<std::string>& files)
+{
+    if (!loadData(files.front(), std::make_shared<InlineExecutor>())) return 0;
+    return filesSize(files);
+}
+
+std::vector<std::pair<std::string, Backend>> backends()
+{
+    std::vector<std::pair<std::string, Backend>> backends{
+        { "ifstream", readIfstream },
+        { "mmap", readMmap },
+        { "pread", readPread },
+    };
+#ifdef SOBJ_BENCH_IO_URING
+    backends.emplace_back("io_uring", readIoUring);
+#endif
+    backends.emplace_back("load", load);
+    return backends;
+}
+
+//--------------------------------------------------
+// MARK: Running
+//--------------------------------------------------
+
+Sample measure(const Backend& backend, const std::vector<std::string>& files, const bool cold)
+{
+    if (cold) evict(files);
+
+    const auto wallBegin  = std::chrono::steady_clock::now();
+    const double cpuBegin = threadCPUSeconds();
+    const size_t bytes    = backend(files);
+    const double cpuEnd   = threadCPUSeconds();
+    const auto wallEnd    = std::chrono::steady_clock::now();
+
+    return Sample{
+        .wallSeconds = std::chrono::duration<double>(wallEnd - wallBegin).count(),
+        .cpuSeconds  = cpuEnd - cpuBegin,
+        .bytes       = bytes,
+    };
+}
+
+/// @brief Prints one row, cpu time and io wait are left blank for stages without cpu times.
+void report(const Result& result)
+{
+    const double wallSeconds = median(result.wallSeconds);
+    const double megabytes   = static_cast<double>(result.bytes) / (1024.0 * 1024.0);
+    const double bandwidth =
+        wallSeconds > 0.0 && result.bytes > 0 ? megabytes / wallSeconds : 0.0;
+    if (result.cpuSeconds.size() != result.wallSeconds.size()) {
+        std::printf("%-28s %10.3f %10s %10s %10.1f\n",
+                    result.stage.c_str(),
+                    wallSeconds * 1e3,
+                    "-",
+                    "-",
+                    bandwidth);
+        return;
+    }
+
+    // single threaded, so whatever the thread did not spend on the cpu it spent waiting
+    std::vector<double> ioWait{};
+    for (size_t i = 0; i < result.wallSeconds.size(); i++) {
+        ioWait.push_back(std::max(0.0, result.wallSeconds[i] - result.cpuSeconds[i]));
+    }
+    std::printf("%-28s %10.3f %10.3f %10.3f %10.1f\n",
+                result.stage.c_str(),
+                wallSeconds * 1e3,
+                median(result.cpuSeconds) * 1e3,
+                median(ioWait) * 1e3,
+                bandwidth);
+}
+
+/// @brief Runs every selected backend on one file. Stages traced during the load backend
+/// become results of their own.
+std::optional<std::vector<Result>> run(const Options& options, const std::string& filePath)
+{
+    const auto files = inputFiles(filePath);
+    if (!files) {
+        std::fprintf(stderr, "error: could not open %s\n", filePath.c_str());
+        return std::nullopt;
+    }
+
+    std::printf("\n%s: %zu files, %zu iterations, %s page cache\n",
+                filePath.c_str(),
+                files->size(),
+                options.iterations,
+                options.cold ? "cold" : "warm");
+    std::printf("%-28s %10s %10s %10s %10s\n", "stage", "wall ms", "cpu ms", "io wait ms",
+                "MiB/s");
+
+    std::vector<Result> results{};
+    for (const auto& [name, backend] : backends()) {
+        if (options.backend != "all" && options.backend != name) continue;
+
+        // one untimed run so the first iteration does not pay for warming up the allocator
+        measure(backend, *files, false);
+
+        sobj::Tracer& tracer = sobj::Tracer::instance();
+        Result result{ .file = filePath, .stage = name };
+        std::map<std::string, Result> stages{};
+        for (size_t i = 0; i < options.iterations; i++) {
+            if (name == "load") {
+                tracer.clear();
+                tracer.enable();
+            }
+            const Sample sample = measure(backend, *files, options.cold);
+            tracer.disable();
+
+            result.bytes = sample.bytes;
+            result.wallSeconds.push_back(sample.wallSeconds);
+            result.cpuSeconds.push_back(sample.cpuSeconds);
+            if (name != "load") continue;
+
+            for (const auto& [stage, duration] : tracer.totals()) {
+                Result& traced = stages[std::string{ stage }];
+                traced.file    = filePath;
+                traced.stage   = stage;
+                // stages may run on other threads, so cpu time is not known
+                traced.wallSeconds.push_back(std::chrono::duration<double>(duration).count());
+            }
+        }
+
+        report(result);
+        results.push_back(std::move(result));
+        for (auto& [_, stage] : stages) {
+            report(stage);
+            results.push_back(std::move(stage));
+        }
+    }
+
+    if (results.empty()) {
+        std::fprintf(stderr, "error: unknown or disabled backend %s\n", options.backend.c_str());
+        return std::nullopt;
+    }
+    return results;
+}
+
+/// @brief Prints how every stage of the candidate changed against the baseline. Returns
+/// whether any stage got significantly slower.
+bool compare(const std::vector<Result>& baseline, const std::vector<Result>& candidate)
+{
+    std::printf("%-40s %-28s %10s %10s %8s %6s\n", "file", "stage", "base ms", "new ms",
+                "change", "z");
+
+    const auto find = [](const std::vector<Result>& results, const Result& other) {
+        return std::ranges::find_if(results, [&](const Result& result) {
+            return result.file == other.file && result.stage == other.stage;
+        });
+    };
+
+    bool regressed = false;
+    for (const Result& after : candidate) {
+        const auto before = find(baseline, after);
+        if (before == baseline.end() || before->wallSeconds.empty() || after.wallSeconds.empty()) {
+            continue;
+        }
+
+        const double baseMedian = median(before->wallSeconds);
+        const double newMedian  = median(after.wallSeconds);
+        const double delta      = newMedian - baseMedian;
+        const double change     = baseMedian > 0.0 ? delta / baseMedian * 100.0 : 0.0;
+        if (std::min(before->wallSeconds.size(), after.wallSeconds.size()) <
+            MIN_COMPARE_SAMPLES) {
+            std::printf("%-40s %-28s %10.3f %10.3f %+7.1f%% %6s\n",
+                        after.file.c_str(),
+                        after.stage.c_str(),
+                        baseMedian * 1e3,
+                        newMedian * 1e3,
+                        change,
+                        "n/a");
+            continue;
+        }
+
+        const auto variance     = [](const Result& result) {
+            const double sigma = MAD_TO_SIGMA * mad(result.wallSeconds);
+            return sigma * sigma / static_cast<double>(result.wallSeconds.size());
+        };
+        const double error = MEDIAN_ERROR * std::sqrt(variance(*before) + variance(after));
+        double z           = 0.0;
+        if (error > 0.0) {
+            z = delta / error;
+        } else if (delta != 0.0) {
+            z = std::copysign(std::numeric_limits<double>::infinity(), delta);
+        }
+
+        const bool significant = std::abs(z) >= SIGNIFICANCE;
+        regressed |= significant && delta > 0.0;
+        std::printf("%-40s %-28s %10.3f %10.3f %+7.1f%% %6.1f %s\n",
+                    after.file.c_str(),
+                    after.stage.c_str(),
+                    baseMedian * 1e3,
+                    newMedian * 1e3,
+                    change,
+                    z,
+                    !significant ? "" : delta > 0.0 ? "slower" : "faster");
+    }
+
+    for (const Result& before : baseline) {
+        if (find(candidate, before) != candidate.end()) continue;
+        std::printf("%-40s %-28s %10.3f %10s %8s %6s missing\n",
+                    before.file.c_str(),
+                    before.stage.c_str(),
+                    median(before.wallSeconds) * 1e3,
+                    "-",
+                    "-",
+                    "-");
+    }
+    return regressed;
+}
+
+//--------------------------------------------------
+// MARK: Scaling
+//--------------------------------------------------
+
+/// @brief 1, 2, 4 ... up to and including maxThreads.
+std::vector<size_t> threadCounts(const size_t maxThreads)
+{
+    std::vector<size_t> counts{};
+    for (size_t count = 1; count < maxThreads; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+/// @brief The calling thread helps in parallelFor, so one thread less is enough for the pool.
+std::shared_ptr<sobj::Executor> executorWithThreads(const size_t numThreads)
+{
+    if (numThreads <= 1) return std::make_shared<InlineExecutor>();
+    return std::make_shared<sobj::ThreadPool>(numThreads - 1);
+}
+
+/// @brief Features working on a single file. data is the file loaded once up front, the
+/// post-processing features run on it.
+std::vector<Feature> fileFeatures(const std::vector<std::string>& files,
+                                  const std::shared_ptr<const sobj::OBJData>& data)
+{
+    const size_t fileBytes = filesSize(files);
+    const size_t dataBytes = sobj::memoryFootprint(*data).total().used;
+
+    std::vector<Feature> features{};
+    features.push_back({ "load", [files, fileBytes](const auto& executor) -> size_t {
+                            const auto loaded = loadData(files.front(), executor);
+                            if (!loaded) return 0;
+                            return fileBytes + sobj::memoryFootprint(*loaded).total().used;
+                        } });
+
+    std::vector<std::string> libraries{};
+    std::ranges::copy_if(files, std::back_inserter(libraries), [](const std::string& path) {
+        return path.ends_with(".mtl");
+    });
+    if (!data->images.empty()) {
+        features.push_back({ "texture decode", [libraries, fileBytes](const auto& executor) {
+                                size_t bytes = fileBytes;
+                                for (const auto& library : libraries) {
+                                    sobj::MTLLoader loader{ std::make_shared<sobj::sobjLogger>(),
+                                                            executor };
+                                    loader.loadMaterialFile(library);
+                                    for (const auto& image : loader.stealImages()) {
+                                        bytes += image.bytes.size();
+                                    }
+                                }
+                                return bytes;
+                            } });
+    }
+
+    features.push_back({ "buildVertexBuffers", [data, dataBytes](const auto& executor) {
+                            size_t bytes = dataBytes;
+                            for (const auto& buffer : sobj::buildVertexBuffers(*data, executor)) {
+                                bytes += buffer.vertices.size() * sizeof(sobj::Vertex) +
+                                         buffer.indices.size() * sizeof(uint32_t);
+                            }
+                            return bytes;
+                        } });
+    features.push_back({ "buildLocalMeshes", [data, dataBytes](const auto& executor) {
+                            size_t bytes = dataBytes;
+                            for (const auto& mesh : sobj::buildLocalMeshes(*data, executor)) {
+                                bytes += (mesh.positions.size() + mesh.normals.size() +
+                                          mesh.colors.size()) * sizeof(sobj::Vec3) +
+                                         mesh.textureUVs.size() * sizeof(sobj::Vec2);
+                            }
+                            return bytes;
+                        } });
+    features.push_back({ "KDTree", [data](const auto& executor) {
+                            const sobj::KDTree tree{ data->positions, executor };
+                            // points, indices and the coordinate copies of the tree
+                            return data->positions.size() *
+                                   (2 * sizeof(sobj::Vec3) + sizeof(uint32_t));
+                        } });
+
+    // both change the data they run on, repeating them on one copy does the same work again
+    const auto copy = std::make_shared<sobj::OBJData>(*data);
+    features.push_back({ "repair", [copy, dataBytes](const auto& executor) {
+                            sobj::repair(*copy, {}, executor);
+                            return dataBytes;
+                        } });
+    features.push_back({ "bakeAmbientOcclusion", [copy, dataBytes](const auto& executor) {
+                            sobj::AmbientOcclusionSettings settings{};
+                            settings.rayCount = SCALING_AO_RAYS;
+                            sobj::bakeAmbientOcclusion(*copy, settings, executor);
+                            return dataBytes;
+                        } });
+    return features;
+}
+
+/// @brief Loads every file of the corpus several times at once on one executor, which is
+/// where shared state such as the metrics or the logger shows up.
+Feature batchFeature(const std::vector<std::string>& filePaths, const size_t numLoads)
+{
+    return { "batch load", [filePaths, numLoads](const auto& executor) {
+                std::atomic<size_t> bytes = 0;
+                executor->parallelFor(numLoads, [&](const size_t i) {
+                    const auto& filePath = filePaths[i % filePaths.size()];
+                    const auto loaded    = loadData(filePath, executor);
+                    if (!loaded) return;
+                    bytes += std::filesystem::file_size(filePath) +
+                             sobj::memoryFootprint(*loaded).total().used;
+                });
+                return bytes.load();
+            } };
+}
+
+/// @brief Runs the feature at every thread count and prints one row per count.
+std::vector<Result> scale(const Feature& feature, const std::string& file,
+                          const Options& options)
+{
+    std::vector<Result> results{};
+    double oneThread = 0.0;
+    for (const size_t numThreads : threadCounts(options.maxThreads)) {
+        const auto executor = executorWithThreads(numThreads);
+        // one untimed run so the pool threads are up and the allocator is warm
+        feature.run(executor);
+
+        Result result{ .file = file, .stage = std::format("{} x{}", feature.name, numThreads) };
+        for (size_t i = 0; i < options.iterations; i++) {
+            const double cpuBegin = processCPUSeconds();
+            const auto begin      = std::chrono::steady_clock::now();
+            result.bytes          = feature.run(executor);
+            const auto end        = std::chrono::steady_clock::now();
+            const double cpuEnd   = processCPUSeconds();
+            result.wallSeconds.push_back(std::chrono::duration<double>(end - begin).count());
+            result.cpuSeconds.push_back(cpuEnd - cpuBegin);
+        }
+
+        const double wallSeconds = median(result.wallSeconds);
+        if (numThreads == 1) oneThread = wallSeconds;
+        const double speedup    = wallSeconds > 0.0 ? oneThread / wallSeconds : 0.0;
+        const double efficiency = speedup / static_cast<double>(numThreads);
+        const double megabytes  = static_cast<double>(result.bytes) / (1024.0 * 1024.0);
+        std::printf("%-22s %7zu %10.3f %10.3f %8.2f %10.2f %10.1f %s\n",
+                    feature.name.c_str(),
+                    numThreads,
+                    wallSeconds * 1e3,
+                    median(result.cpuSeconds) * 1e3,
+                    speedup,
+                    efficiency,
+                    wallSeconds > 0.0 ? megabytes / wallSeconds : 0.0,
+                    numThreads > 1 && efficiency < LOW_EFFICIENCY ? "low" : "");
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+std::optional<std::vector<Result>> runScaling(const Options& options)
+{
+    const auto printHeader = [] {
+        std::printf("%-22s %7s %10s %10s %8s %10s %10s\n", "feature", "threads", "wall ms",
+                    "cpu ms", "speedup", "efficiency", "MiB/s");
+    };
+
+    std::vector<Result> results{};
+    for (const auto& filePath : options.filePaths) {
+        const auto files = inputFiles(filePath);
+        const auto data  = files ? loadData(filePath, nullptr) : std::nullopt;
+        if (!data) {
+            std::fprintf(stderr, "error: could not load %s\n", filePath.c_str());
+            return std::nullopt;
+        }
+
+        std::printf("\n%s: %zu iterations, up to %zu threads\n",
+                    filePath.c_str(),
+                    options.iterations,
+                    options.maxThreads);
+        printHeader();
+        const auto shared = std::make_shared<const sobj::OBJData>(std::move(*data));
+        for (const auto& feature : fileFeatures(*files, shared)) {
+            std::ranges::move(scale(feature, filePath, options), std::back_inserter(results));
+        }
+    }
+
+    const size_t numLoads =
+        std::max(options.filePaths.size(), BATCH_LOADS_PER_THREAD * options.maxThreads);
+    std::printf("\ncorpus: %zu loads at once\n", numLoads);
+    printHeader();
+    std::ranges::move(scale(batchFeature(options.filePaths, numLoads), "corpus", options),
+                      std::back_inserter(results));
+    return results;
+}
+
+std::optional<Options> parseOptions(const int argc, char** argv)
+{
+    Options options{};
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--cold") {
+            options.cold = true;
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            options.iterations = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--backend" && i + 1 < argc) {
+            options.backend = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--scaling") {
+            options.scaling = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.maxThreads = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--compare" && i + 2 < argc) {
+            options.compare = { argv[i + 1], argv[i + 2] };
+            i += 2;
+        } else if (!arg.starts_with("--")) {
+            options.filePaths.emplace_back(arg);
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (options.filePaths.empty() == !options.compare) return std::nullopt;
+    return options;
+}
+} // namespace
+
+int main(const int argc, char** argv)
+{
+    const auto options = parseOptions(argc, argv);
+    if (!options) {
+        std::fprintf(stderr,
+                     "usage: %s [--cold] [--iterations N] [--backend NAME] [--json FILE] "
+                     "file.obj...\n"
+                     "       %s --scaling [--threads N] [--iterations N] [--json FILE] "
+                     "file.obj...\n"
+                     "       %s --compare BASELINE.json CANDIDATE.json\n",
+                     argv[0],
+                     argv[0],
+                     argv[0]);
+        return 1;
+    }
+
+    if (options->compare) {
+        const auto& [baselinePath, candidatePath] = *options->compare;
+        const auto baseline  = readResults(baselinePath);
+        const auto candidate = readResults(candidatePath);
+        if (!baseline || !candidate) {
+            std::fprintf(stderr, "error: could not read %s\n",
+                         (baseline ? candidatePath : baselinePath).c_str());
+            return 1;
+        }
+        return compare(*baseline, *candidate) ? 2 : 0;
+    }
+
+    std::vector<Result> results{};
+    if (options->scaling) {
+        auto scalingResults = runScaling(*options);
+        if (!scalingResults) return 1;
+        results = std::move(*scalingResults);
+    } else {
+        for (const auto& filePath : options->filePaths) {
+            auto fileResults = run(*options, filePath);
+            if (!fileResults) return 1;
+            std::ranges::move(*fileResults, std::back_inserter(results));
+        }
+    }
+
+    if (!options->jsonPath.empty() &&
+        !writeResults(options->jsonPath, options->iterations, options->cold, results)) {
+        std::fprintf(stderr, "error: could not write %s\n", options->jsonPath.c_str());
+        return 1;
+    }
+    return 0;
+}
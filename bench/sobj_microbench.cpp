@@ -0,0 +1,525 @@
+// Microbenchmarks for the primitives sobj's parsers are built from.
+//
+// Every kernel runs over a fixed synthetic input that is generated the same way on every
+// run, so a change in a single primitive shows up even when it drowns in the noise of a whole
+// load. Kernels run on the calling thread and report the median time per operation over
+// all repetitions.
+//
+// Build with the same include paths as any other sobj user, for example
+//     c++ -std=c++23 -O2 -I.. sobj_microbench.cpp -o sobj_microbench -pthread
+//
+// Usage: sobj_microbench [--repetitions N] [--filter TEXT] [--json FILE]
+// --filter only runs kernels whose name contains TEXT. --json writes the time of every pass
+// over a kernel's input in the format of sobj_bench, so sobj_bench --compare diffs it.
+
+#define SOBJ_IMPLEMENTATION
+#include "../sobj.hpp"
+#include "bench_results.hpp"
+
+#include <cstdio>
+#include <numeric>
+#include <time.h>
+
+namespace
+{
+using namespace bench;
+
+//--------------------------------------------------
+// MARK: Constants
+//--------------------------------------------------
+
+constexpr size_t NUM_LINES           = 4096;
+constexpr size_t DEFAULT_REPETITIONS = 15;
+// passes are repeated until they take at least this long, so timer resolution does not matter
+constexpr double MIN_PASS_SECONDS = 0.01;
+constexpr int IMAGE_SIZE          = 256;
+constexpr size_t MAX_STORED_BLOCK = 65535;
+constexpr uint64_t SEED           = 0x5EED;
+
+//--------------------------------------------------
+// MARK: Data Classes
+//--------------------------------------------------
+
+struct Options {
+    size_t repetitions = DEFAULT_REPETITIONS;
+    std::string filter{};
+    std::string jsonPath{};
+};
+
+/// @brief A primitive together with the input it runs on. run does one pass over the whole
+/// input and returns how many operations that were.
+struct Kernel {
+    std::string name{};
+    std::function<size_t()> run{};
+};
+
+/// @brief Runs everything on the submitting thread so decodes stay single threaded.
+class InlineExecutor final : public sobj::Executor
+{
+public:
+    void submit(std::function<void()> task) override
+    {
+        task();
+    }
+
+    void wait() override
+    {
+    }
+
+    size_t concurrency() const override
+    {
+        return 1;
+    }
+};
+
+//--------------------------------------------------
+// MARK: Utilities
+//--------------------------------------------------
+
+/// @brief Keeps the compiler from dropping a computation whose result is unused.
+template <typename T> void keep(const T& value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+/// @brief Small deterministic generator, the inputs must not change between runs.
+class Random
+{
+public:
+    uint32_t next()
+    {
+        m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<uint32_t>(m_state >> 33);
+    }
+
+    uint32_t below(const uint32_t bound)
+    {
+        return next() % bound;
+    }
+
+    float uniform(const float min, const float max)
+    {
+        return min + (max - min) * static_cast<float>(next()) / static_cast<float>(1u << 31);
+    }
+
+private:
+    uint64_t m_state = SEED;
+};
+
+double threadCPUSeconds()
+{
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+}
+
+uint32_t crc32(const std::string_view bytes, uint32_t crc = 0)
+{
+    crc = ~crc;
+    for (const char byte : bytes) {
+        crc ^= static_cast<unsigned char>(byte);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = crc & 1 ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+void appendBigEndian(std::string& out, const uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out += static_cast<char>(value >> shift & 0xFF);
+    }
+}
+
+/// @brief Encodes an rgba png with uncompressed deflate blocks, which is all the synthetic
+/// texture needs and keeps the benchmark free of an encoder dependency.
+std::string encodePNG(const int width, const int height, const std::vector<unsigned char>& rgba)
+{
+    // every row starts with filter type 0
+    std::string raw{};
+    for (int y = 0; y < height; y++) {
+        raw += '\0';
+        raw.append(reinterpret_cast<const char*>(rgba.data()) + static_cast<size_t>(y) * width * 4,
+                   static_cast<size_t>(width) * 4);
+    }
+
+    std::string zlib{ "\x78\x01" };
+    for (size_t offset = 0; offset < raw.size(); offset += MAX_STORED_BLOCK) {
+        const size_t length = std::min(MAX_STORED_BLOCK, raw.size() - offset);
+        zlib += static_cast<char>(offset + length == raw.size());
+        zlib += static_cast<char>(length & 0xFF);
+        zlib += static_cast<char>(length >> 8);
+        zlib += static_cast<char>(~length & 0xFF);
+        zlib += static_cast<char>(~length >> 8 & 0xFF);
+        zlib.append(raw, offset, length);
+    }
+    uint32_t a = 1, b = 0;
+    for (const char byte : raw) {
+        a = (a + static_cast<unsigned char>(byte)) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(zlib, b << 16 | a);
+
+    std::string png{ "\x89PNG\r\n\x1a\n", 8 };
+    const auto chunk = [&](const std::string_view type, const std::string& data) {
+        appendBigEndian(png, static_cast<uint32_t>(data.size()));
+        const std::string body = std::string{ type } + data;
+        png += body;
+        appendBigEndian(png, crc32(body));
+    };
+
+    std::string header{};
+    appendBigEndian(header, static_cast<uint32_t>(width));
+    appendBigEndian(header, static_cast<uint32_t>(height));
+    header += std::string{ "\x08\x06\x00\x00\x00", 5 }; // 8 bit rgba, no interlace
+    chunk("IHDR", header);
+    chunk("IDAT", zlib);
+    chunk("IEND", {});
+    return png;
+}
+
+//--------------------------------------------------
+// MARK: Inputs
+//--------------------------------------------------
+
+std::string number(Random& random)
+{
+    // mix plain, negative and exponent notation like real exporters write them
+    const float value = random.uniform(-100.0f, 100.0f);
+    switch (random.below(3)) {
+    case 0: return std::format("{:.6f}", value);
+    case 1: return std::format("{:.3f}", value / 100.0f);
+    default: return std::format("{:.6e}", value);
+    }
+}
+
+std::vector<std::string> vectorLines()
+{
+    Random random{};
+    std::vector<std::string> lines{};
+    for (size_t i = 0; i < NUM_LINES; i++) {
+        lines.push_back(
+            std::format("v {} {} {}", number(random), number(random), number(random)));
+    }
+    return lines;
+}
+
+/// @brief Quads in one of the four face syntaxes, format receives the three indices of
+/// every vertex.
+std::vector<std::string> faceLines(std::string (*format)(uint32_t, uint32_t, uint32_t))
+{
+    Random random{};
+    std::vector<std::string> lines{};
+    for (size_t i = 0; i < NUM_LINES; i++) {
+        std::string line{ "f" };
+        const uint32_t first = random.below(1 << 20) + 1;
+        for (uint32_t v = 0; v < 4; v++) {
+            line += ' ';
+            line += format(first + v, first + v + random.below(2), first + v);
+        }
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+std::vector<std::string> objLines()
+{
+    constexpr std::array PREFIXES{ "v 1 2 3",   "vn 0 1 0",      "vt 0.5 0.5",    "f 1 2 3",
+                                   "g group",   "o object",      "s 1",           "mtllib a.mtl",
+                                   "usemtl m",  "# comment",     "",              "unknown" };
+    // weighted towards the lines that dominate real files
+    constexpr std::array WEIGHTS{ 30, 20, 20, 25, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+    Random random{};
+    std::vector<std::string> lines{};
+    const int total = std::accumulate(WEIGHTS.begin(), WEIGHTS.end(), 0);
+    for (size_t i = 0; i < NUM_LINES; i++) {
+        int pick = static_cast<int>(random.below(total));
+        size_t index = 0;
+        while (pick >= WEIGHTS[index]) pick -= WEIGHTS[index++];
+        lines.emplace_back(PREFIXES[index]);
+    }
+    return lines;
+}
+
+std::vector<std::string> mtlLines()
+{
+    constexpr std::array LINES{ "newmtl m", "Ka 1 1 1", "Kd 0.5 0.5 0.5", "Ks 0 0 0",
+                                "Ns 10",    "d 1",      "map_Kd a.png",   "map_Ka a.png",
+                                "map_Ks a.png", "map_Ns a.png", "map_d a.png", "# comment" };
+
+    Random random{};
+    std::vector<std::string> lines{};
+    for (size_t i = 0; i < NUM_LINES; i++) {
+        lines.emplace_back(LINES[random.below(LINES.size())]);
+    }
+    return lines;
+}
+
+std::vector<std::string> paddedLines()
+{
+    constexpr std::array PADDING{ "", " ", "  ", "\t", " \t ", "    " };
+
+    Random random{};
+    std::vector<std::string> lines{};
+    for (const auto& line : vectorLines()) {
+        lines.push_back(std::string{ PADDING[random.below(PADDING.size())] } + line +
+                        PADDING[random.below(PADDING.size())]);
+    }
+    return lines;
+}
+
+sobj::Mesh quadMesh()
+{
+    Random random{};
+    sobj::Mesh mesh{};
+    for (size_t i = 0; i < NUM_LINES; i++) {
+        sobj::Face face{};
+        const uint32_t first = random.below(1 << 20);
+        face.positionIndices = { first, first + 1, first + 2, first + 3 };
+        face.uvIndices       = face.positionIndices;
+        face.normalIndices   = face.positionIndices;
+        mesh.faces.push_back(std::move(face));
+    }
+    return mesh;
+}
+
+std::filesystem::path textureDirectory()
+{
+    return std::filesystem::temp_directory_path() / std::format("sobj_microbench_{}", getpid());
+}
+
+/// @brief Writes a material library with one synthetic texture into textureDirectory() and
+/// returns the path of the library.
+std::optional<std::string> writeTexture()
+{
+    std::vector<unsigned char> rgba(static_cast<size_t>(IMAGE_SIZE) * IMAGE_SIZE * 4);
+    for (int y = 0; y < IMAGE_SIZE; y++) {
+        for (int x = 0; x < IMAGE_SIZE; x++) {
+            unsigned char* pixel = &rgba[(static_cast<size_t>(y) * IMAGE_SIZE + x) * 4];
+            pixel[0]             = static_cast<unsigned char>(x);
+            pixel[1]             = static_cast<unsigned char>(y);
+            pixel[2]             = static_cast<unsigned char>(x ^ y);
+            pixel[3]             = 255;
+        }
+    }
+
+    const auto directory = textureDirectory();
+    std::error_code error{};
+    std::filesystem::create_directories(directory, error);
+    if (error) return std::nullopt;
+
+    std::ofstream{ directory / "texture.png", std::ios::binary }
+        << encodePNG(IMAGE_SIZE, IMAGE_SIZE, rgba);
+    std::ofstream{ directory / "texture.mtl" } << "newmtl textured\nmap_Kd texture.png\n";
+    return (directory / "texture.mtl").string();
+}
+
+//--------------------------------------------------
+// MARK: Kernels
+//--------------------------------------------------
+
+/// @brief The replacement candidate for MathParser::parseVec3, kept next to it so both
+/// are measured on the same input.
+std::optional<sobj::Vec3> parseVec3FromChars(const std::string_view line)
+{
+    std::array<float, 3> values{};
+    const char* begin = line.data() + line.find(' ');
+    const char* end   = line.data() + line.size();
+    for (float& value : values) {
+        while (begin < end && *begin == ' ') begin++;
+        const auto [ptr, error] = std::from_chars(begin, end, value);
+        if (error != std::errc{}) return std::nullopt;
+        begin = ptr;
+    }
+    return sobj::Vec3{ values[0], values[1], values[2] };
+}
+
+std::vector<Kernel> kernels()
+{
+    std::vector<Kernel> kernels{};
+
+    const auto vectors = std::make_shared<std::vector<std::string>>(vectorLines());
+    kernels.push_back({ "MathParser::parseVec3", [vectors] {
+                           const sobj::MathParser parser{};
+                           for (const auto& line : *vectors) keep(parser.parseVec3(line));
+                           return vectors->size();
+                       } });
+    kernels.push_back({ "parseVec3/from_chars", [vectors] {
+                           for (const auto& line : *vectors) keep(parseVec3FromChars(line));
+                           return vectors->size();
+                       } });
+
+    using Format = std::string (*)(uint32_t, uint32_t, uint32_t);
+    const std::array<std::pair<const char*, Format>, 4> syntaxes{ {
+        { "parseFace v", [](uint32_t v, uint32_t, uint32_t) { return std::format("{}", v); } },
+        { "parseFace v/vt",
+          [](uint32_t v, uint32_t vt, uint32_t) { return std::format("{}/{}", v, vt); } },
+        { "parseFace v//vn",
+          [](uint32_t v, uint32_t, uint32_t vn) { return std::format("{}//{}", v, vn); } },
+        { "parseFace v/vt/vn",
+          [](uint32_t v, uint32_t vt, uint32_t vn) {
+              return std::format("{}/{}/{}", v, vt, vn);
+          } },
+    } };
+    for (const auto& [name, format] : syntaxes) {
+        const auto faces = std::make_shared<std::vector<std::string>>(faceLines(format));
+        kernels.push_back({ name, [faces] {
+                               sobj::sobjLogger logger{};
+                               for (const auto& line : *faces) {
+                                   keep(sobj::detail::parseFace(line, {}, logger, "", 0));
+                               }
+                               return faces->size();
+                           } });
+    }
+
+    const auto obj = std::make_shared<std::vector<std::string>>(objLines());
+    kernels.push_back({ "detail::objIdentifier", [obj] {
+                           for (const auto& line : *obj) keep(sobj::detail::objIdentifier(line));
+                           return obj->size();
+                       } });
+    const auto mtl = std::make_shared<std::vector<std::string>>(mtlLines());
+    kernels.push_back({ "detail::mtlIdentifier", [mtl] {
+                           for (const auto& line : *mtl) keep(sobj::detail::mtlIdentifier(line));
+                           return mtl->size();
+                       } });
+
+    // copying into a buffer with enough capacity does not allocate, so this is mostly trim
+    const auto padded = std::make_shared<std::vector<std::string>>(paddedLines());
+    kernels.push_back({ "detail::trim", [padded] {
+                           std::string buffer{};
+                           buffer.reserve(256);
+                           for (const auto& line : *padded) {
+                               buffer.assign(line);
+                               sobj::detail::trim(buffer);
+                               keep(buffer);
+                           }
+                           return padded->size();
+                       } });
+
+    const auto quads = std::make_shared<sobj::Mesh>(quadMesh());
+    kernels.push_back({ "detail::triangulate", [quads] {
+                           for (const auto& face : quads->faces) {
+                               keep(sobj::detail::triangulate(face));
+                           }
+                           return quads->faces.size();
+                       } });
+    kernels.push_back({ "TriangleView", [quads] {
+                           size_t count = 0;
+                           for (const sobj::Triangle& triangle : sobj::TriangleView{ *quads }) {
+                               keep(triangle);
+                               count++;
+                           }
+                           return count;
+                       } });
+
+    if (const auto library = writeTexture()) {
+        kernels.push_back({ "image decode", [path = *library] {
+                               auto logger = std::make_shared<sobj::sobjLogger>();
+                               sobj::MTLLoader loader{ logger,
+                                                       std::make_shared<InlineExecutor>() };
+                               loader.loadMaterialFile(path);
+                               keep(loader.stealImages());
+                               return size_t{ 1 };
+                           } });
+    } else {
+        std::fprintf(stderr, "warning: could not write the texture, skipping image decode\n");
+    }
+    return kernels;
+}
+
+//--------------------------------------------------
+// MARK: Running
+//--------------------------------------------------
+
+/// @brief Times one pass, repeated until it is long enough to measure.
+Result measure(const Kernel& kernel, const size_t repetitions, size_t& operations)
+{
+    operations        = kernel.run();
+    size_t passes     = 1;
+    const auto begin  = std::chrono::steady_clock::now();
+    kernel.run();
+    const auto once = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin);
+    if (once.count() < MIN_PASS_SECONDS) {
+        passes = static_cast<size_t>(MIN_PASS_SECONDS / std::max(once.count(), 1e-9)) + 1;
+    }
+
+    Result result{ .file = "synthetic", .stage = kernel.name };
+    for (size_t i = 0; i < repetitions; i++) {
+        const auto wallBegin  = std::chrono::steady_clock::now();
+        const double cpuBegin = threadCPUSeconds();
+        for (size_t pass = 0; pass < passes; pass++) kernel.run();
+        const double cpuEnd = threadCPUSeconds();
+        const auto wallEnd  = std::chrono::steady_clock::now();
+
+        const double wall = std::chrono::duration<double>(wallEnd - wallBegin).count();
+        result.wallSeconds.push_back(wall / static_cast<double>(passes));
+        result.cpuSeconds.push_back((cpuEnd - cpuBegin) / static_cast<double>(passes));
+    }
+    return result;
+}
+
+void report(const Result& result, const size_t operations)
+{
+    const double perOperation = median(result.wallSeconds) / static_cast<double>(operations);
+    const double spread       = mad(result.wallSeconds) / static_cast<double>(operations);
+    std::printf("%-24s %8zu %12.1f %10.1f %14.0f\n",
+                result.stage.c_str(),
+                operations,
+                perOperation * 1e9,
+                spread * 1e9,
+                perOperation > 0.0 ? 1.0 / perOperation : 0.0);
+}
+
+std::optional<Options> parseOptions(const int argc, char** argv)
+{
+    Options options{};
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--repetitions" && i + 1 < argc) {
+            options.repetitions = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+} // namespace
+
+int main(const int argc, char** argv)
+{
+    const auto options = parseOptions(argc, argv);
+    if (!options) {
+        std::fprintf(stderr,
+                     "usage: %s [--repetitions N] [--filter TEXT] [--json FILE]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    std::printf("%zu repetitions\n", options->repetitions);
+    std::printf("%-24s %8s %12s %10s %14s\n", "kernel", "ops", "ns/op", "mad ns", "ops/s");
+
+    std::vector<Result> results{};
+    for (const Kernel& kernel : kernels()) {
+        if (!kernel.name.contains(options->filter)) continue;
+
+        size_t operations = 0;
+        results.push_back(measure(kernel, options->repetitions, operations));
+        report(results.back(), operations);
+    }
+
+    std::error_code error{};
+    std::filesystem::remove_all(textureDirectory(), error);
+
+    if (!options->jsonPath.empty() &&
+        !writeResults(options->jsonPath, options->repetitions, false, results)) {
+        std::fprintf(stderr, "error: could not write %s\n", options->jsonPath.c_str());
+        return 1;
+    }
+    return 0;
+}
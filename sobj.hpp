@@ -2,18 +2,52 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numbers>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <sstream>
+#include <stdexcept>
 #include <stb_image.hpp>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOBJ_SSE2
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SOBJ_POSIX
+#endif
+
 // sobj can optionally use the logging library slog which can be found at
 // https://github.com/sleeepyskies/slog
 #ifdef SOBJ_USE_SLOG
@@ -35,7 +69,11 @@ constexpr char DELIMITER                = '/';
 constexpr char SPACE                    = ' ';
 constexpr std::string ON                = "on";
 constexpr std::string OFF               = "off";
-constexpr std::string GROUP_NAME_PREFIX = "group";
+constexpr std::string DEFAULT_MESH_NAME = "default";
+constexpr uint32_t NO_INDEX             = UINT32_MAX;
+// buffers smaller than this are cheaper to allocate again than to pool
+constexpr size_t MIN_POOLED_BUFFER_SIZE = 64 * 1024;
+constexpr size_t DEFAULT_POOL_SIZE      = 256 * 1024 * 1024;
 } // namespace detail
 
 //--------------------------------------------------
@@ -50,8 +88,87 @@ struct Vec2 {
     float x, y;
 };
 
+/// @brief Column major 4x4 matrix.
+struct Mat4 {
+    std::array<float, 16> values{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+    static Mat4 scale(float factor);
+    /// @brief Converts from z up to y up, (x, y, z) becomes (x, z, -y).
+    static Mat4 zUpToYUp();
+
+    Mat4 operator*(const Mat4& other) const;
+    Vec3 transformPoint(const Vec3& point) const;
+    Vec3 transformDirection(const Vec3& direction) const;
+    /// @brief Inverse transpose of the upper 3x3, for transforming normals.
+    Mat4 normalMatrix() const;
+};
+
+/// @brief Heap bytes holding elements (used) and heap bytes allocated (reserved).
+struct MemoryUsage {
+    size_t used     = 0;
+    size_t reserved = 0;
+
+    MemoryUsage& operator+=(const MemoryUsage& other)
+    {
+        used += other.used;
+        reserved += other.reserved;
+        return *this;
+    }
+};
+
+/// @brief Counts the heap bytes a load holds and their high-water mark. Shared between an
+/// OBJLoader and the MTLLoaders it starts, which report from other threads.
+class MemoryTracker
+{
+public:
+    void allocate(size_t bytes);
+    void release(size_t bytes);
+    size_t peak() const;
+    void reset();
+
+private:
+    std::atomic<size_t> m_current = 0;
+    std::atomic<size_t> m_peak    = 0;
+};
+
+using NameID = uint32_t;
+
+/// @brief Interns strings into an arena. IDs are stable and the returned views stay valid
+/// for as long as the pool is alive, copies re-intern in ID order.
+class NamePool
+{
+public:
+    NamePool() = default;
+    NamePool(const NamePool& other);
+    NamePool(NamePool&& other) noexcept;
+    NamePool& operator=(const NamePool& other);
+    NamePool& operator=(NamePool&& other) noexcept;
+    ~NamePool() = default;
+
+    NameID intern(std::string_view name);
+    std::optional<NameID> find(std::string_view name) const;
+    std::string_view view(NameID id) const;
+    size_t size() const;
+    void clear();
+    /// @brief Arena, views and lookup table. The lookup table is estimated since the node
+    /// layout of std::unordered_map is implementation defined.
+    MemoryUsage memoryUsage() const;
+    /// @brief memoryUsage().reserved without walking every name.
+    size_t reservedBytes() const;
+
+private:
+    static constexpr size_t BLOCK_SIZE = 16 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> m_blocks{};
+    char* m_blockCursor     = nullptr;
+    size_t m_blockRemaining = 0;
+    size_t m_blockBytes     = 0;
+    std::vector<std::string_view> m_names{};
+    std::unordered_map<std::string_view, NameID> m_nameToID{};
+};
+
 struct ImageData {
-    std::string name{};
+    NameID name = 0;
     std::vector<unsigned char> bytes{};
     int width    = 0;
     int height   = 0;
@@ -59,7 +176,7 @@ struct ImageData {
 };
 
 struct Material {
-    std::string name{};
+    NameID name = 0;
 
     std::optional<uint32_t> ambientMapIndex   = std::nullopt; // Ka
     std::optional<uint32_t> diffuseMapIndex   = std::nullopt; // Kd
@@ -86,10 +203,32 @@ struct Face {
     }
 };
 
+/// @brief Start of a run of faces sharing the same smoothing group.
+struct SmoothingRun {
+    uint32_t firstFace = 0;
+    uint32_t group     = 0;
+};
+
 struct Mesh {
-    std::string name{};
+    NameID name = 0;
+    // every name of a "g a b c" line, name is the first of them
+    std::vector<NameID> groups{};
     std::vector<Face> faces{};
     std::optional<uint32_t> materialIndex = std::nullopt;
+    // true if every face vertex uses the same index for its position, uv and normal
+    bool unifiedIndices = true;
+    // run length encoded smoothing group per face, faces before the first run are in group 0
+    std::vector<SmoothingRun> smoothingGroups{};
+
+    /// @brief Smoothing group of the given face, 0 means smoothing is off.
+    uint32_t smoothingGroup(const size_t faceIndex) const
+    {
+        const auto it = std::ranges::upper_bound(
+            smoothingGroups, faceIndex, {}, [](const SmoothingRun& run) -> size_t {
+                return run.firstFace;
+            });
+        return it == smoothingGroups.begin() ? 0 : std::prev(it)->group;
+    }
 };
 
 struct OBJData {
@@ -101,6 +240,212 @@ struct OBJData {
     std::vector<Mesh> meshes{};
     std::vector<Material> materials{};
     std::vector<ImageData> images{};
+    // names of meshes, materials and images
+    NamePool names{};
+};
+
+/// @brief Heap memory owned by an OBJData, see memoryFootprint.
+struct MemoryFootprint {
+    MemoryUsage positions{};
+    MemoryUsage normals{};
+    MemoryUsage textureUVs{};
+    MemoryUsage colors{};
+    // Face array plus the four index vectors of every face, per mesh and summed up
+    std::vector<MemoryUsage> meshFaces{};
+    MemoryUsage faces{};
+    // Mesh array, group names and smoothing runs
+    MemoryUsage meshes{};
+    MemoryUsage materials{};
+    // ImageData array and decoded pixels
+    MemoryUsage images{};
+    // name pool and OBJData::name
+    MemoryUsage names{};
+
+    MemoryUsage total() const
+    {
+        MemoryUsage sum = positions;
+        for (const auto& usage : { normals, textureUVs, colors, faces, meshes, materials, images,
+                                   names }) {
+            sum += usage;
+        }
+        return sum;
+    }
+};
+
+/// @brief Lightweight description of an obj file, see OBJLoader::scan.
+struct OBJSummary {
+    std::string name{};
+    size_t numPositions = 0;
+    size_t numNormals   = 0;
+    size_t numUVs       = 0;
+    size_t numFaces     = 0;
+    // unique names in order of first appearance
+    std::vector<std::string> groups{};
+    std::vector<std::string> objects{};
+    std::vector<std::string> materials{};
+    std::vector<std::string> materialLibraries{};
+    std::vector<std::string> textures{};
+};
+
+/// @brief A mesh that was completed while its file is still being parsed, together with
+/// all vertex data parsed so far. Only valid for the duration of the callback.
+struct MeshView {
+    const Mesh& mesh;
+    size_t meshIndex = 0; // index into OBJData::meshes once loading has finished
+    std::string_view name{};
+    // usemtl is resolved at the end of the load, so only the name is known here
+    std::optional<std::string_view> materialName = std::nullopt;
+    std::span<const Vec3> positions{};
+    std::span<const Vec3> normals{};
+    std::span<const Vec2> textureUVs{};
+    std::span<const Vec3> colors{};
+};
+
+using MeshCallback = std::function<void(const MeshView&)>;
+
+struct Vertex {
+    Vec3 position{};
+    Vec3 normal{};
+    Vec2 uv{};
+};
+
+/// @brief GPU ready interleaved vertices with a triangle index list.
+struct VertexBuffer {
+    std::vector<Vertex> vertices{};
+    std::vector<uint32_t> indices{};
+};
+
+/// @brief A mesh with its own compacted copy of the attributes it uses. The faces of mesh
+/// index into the vectors below instead of those of OBJData, in order of first use.
+struct LocalMesh {
+    Mesh mesh{};
+    std::vector<Vec3> positions{};
+    std::vector<Vec3> normals{};
+    std::vector<Vec2> textureUVs{};
+    std::vector<Vec3> colors{};
+    // index into OBJData::positions of every local position, to map results back
+    std::vector<uint32_t> positionSources{};
+};
+
+/// @brief Triangle cut from a face, indices point into OBJData just like those of Face.
+/// Attributes the face does not have are detail::NO_INDEX.
+struct Triangle {
+    std::array<uint32_t, 3> positionIndices{};
+    std::array<uint32_t, 3> normalIndices{};
+    std::array<uint32_t, 3> uvIndices{};
+    std::array<uint32_t, 3> colorIndices{};
+    size_t faceIndex = 0; // into Mesh::faces
+};
+
+/// @brief Triangulates the faces of a mesh while iterating. Polygons are cut into a fan
+/// around their first vertex like OBJLoader does, faces with less than 3 vertices are
+/// skipped. Load with setShouldTriangulate(false) to keep faces compact and use this instead.
+class TriangleView : public std::ranges::view_interface<TriangleView>
+{
+public:
+    class Iterator
+    {
+    public:
+        using value_type        = Triangle;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_concept  = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag; // triangles are made on the fly
+
+        Iterator() = default;
+        Iterator(const Mesh* mesh, const size_t face, const size_t lastFace)
+            : m_mesh(mesh), m_face(face), m_lastFace(lastFace)
+        {
+            skipDegenerateFaces();
+        }
+
+        Triangle operator*() const
+        {
+            const Face& face = m_mesh->faces[m_face];
+            const std::array<size_t, 3> corners{ 0, m_fan + 1, m_fan + 2 };
+            const auto gather = [&](const std::vector<uint32_t>& indices) {
+                std::array<uint32_t, 3> result{ detail::NO_INDEX, detail::NO_INDEX,
+                                                detail::NO_INDEX };
+                if (indices.empty()) return result;
+                for (size_t i = 0; i < 3; i++) {
+                    result[i] = indices[corners[i]];
+                }
+                return result;
+            };
+
+            return Triangle{
+                .positionIndices = gather(face.positionIndices),
+                .normalIndices   = gather(face.normalIndices),
+                .uvIndices       = gather(face.uvIndices),
+                .colorIndices    = gather(face.colorIndices),
+                .faceIndex       = m_face,
+            };
+        }
+
+        Iterator& operator++()
+        {
+            if (++m_fan + 2 >= m_mesh->faces[m_face].numVertices()) {
+                m_fan = 0;
+                m_face++;
+                skipDegenerateFaces();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return m_face == other.m_face && m_fan == other.m_fan;
+        }
+
+    private:
+        const Mesh* m_mesh = nullptr;
+        size_t m_face      = 0;
+        size_t m_lastFace  = 0;
+        size_t m_fan       = 0; // triangle within the current face
+
+        void skipDegenerateFaces()
+        {
+            while (m_face < m_lastFace && m_mesh->faces[m_face].numVertices() < 3) {
+                m_face++;
+            }
+        }
+    };
+
+    TriangleView() = default;
+    explicit TriangleView(const Mesh& mesh) : TriangleView(mesh, 0, mesh.faces.size())
+    {
+    }
+    /// @brief Only the triangles of the faces in [firstFace, lastFace).
+    TriangleView(const Mesh& mesh, const size_t firstFace, const size_t lastFace)
+        : m_mesh(&mesh), m_firstFace(firstFace), m_lastFace(lastFace)
+    {
+        assert(firstFace <= lastFace && lastFace <= mesh.faces.size());
+    }
+
+    Iterator begin() const
+    {
+        return { m_mesh, m_firstFace, m_lastFace };
+    }
+
+    Iterator end() const
+    {
+        return { m_mesh, m_lastFace, m_lastFace };
+    }
+
+    /// @brief Cuts the faces into at most parts runs of about equal length, so each view can
+    /// be iterated on its own thread. Together they yield the same triangles as this view.
+    std::vector<TriangleView> split(size_t parts) const;
+
+private:
+    const Mesh* m_mesh = nullptr;
+    size_t m_firstFace = 0;
+    size_t m_lastFace  = 0;
 };
 
 //--------------------------------------------------
@@ -134,6 +479,145 @@ inline std::string fileNameFromPath(const std::string& path)
     return path.substr(path.find_last_of("/\\") + 1);
 }
 
+/// @brief Task that is run by whichever thread gets to it first, either the executor or the
+/// thread that needs its result. Avoids deadlocks when the executor is saturated.
+template <typename T> class ClaimableTask
+{
+public:
+    explicit ClaimableTask(std::function<T()> fn) : m_fn(std::move(fn))
+    {
+    }
+
+    void run()
+    {
+        if (m_claimed.exchange(true)) return;
+        try {
+            m_promise.set_value(m_fn());
+        } catch (...) {
+            m_promise.set_exception(std::current_exception());
+        }
+        // drop the captures right away, the task itself may outlive them inside the executor
+        m_fn = nullptr;
+    }
+
+    T get()
+    {
+        run();
+        return m_future.get();
+    }
+
+private:
+    std::function<T()> m_fn;
+    std::promise<T> m_promise{};
+    std::future<T> m_future = m_promise.get_future();
+    std::atomic<bool> m_claimed = false;
+};
+
+/// @brief Calls fn when it goes out of scope, whichever way the scope is left.
+template <typename Fn> class ScopeExit
+{
+public:
+    explicit ScopeExit(Fn fn) : m_fn(std::move(fn))
+    {
+    }
+    ~ScopeExit()
+    {
+        m_fn();
+    }
+    ScopeExit(const ScopeExit&)            = delete;
+    ScopeExit& operator=(const ScopeExit&) = delete;
+
+private:
+    Fn m_fn;
+};
+
+/// @brief Read only view of a whole file. Memory mapped where available, read into a buffer
+/// otherwise.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filePath);
+    std::string_view view() const;
+
+private:
+#ifdef SOBJ_POSIX
+    void* m_mapping = nullptr;
+    size_t m_size   = 0;
+#endif
+    std::vector<char> m_buffer{};
+};
+
+#ifdef SOBJ_POSIX
+constexpr uint64_t SHARED_MAGIC   = 0x314a424f53; // "SOBJ1"
+constexpr uint32_t SHARED_VERSION = 1;
+
+/// @brief Array stored at an offset from the start of a shared memory segment.
+struct SharedArray {
+    uint64_t offset = 0;
+    uint64_t count  = 0;
+};
+
+struct SharedMesh {
+    NameID name             = 0;
+    uint32_t materialIndex  = NO_INDEX;
+    uint32_t unifiedIndices = 0;
+    SharedArray groups{};
+    SharedArray faceOffsets{};
+    SharedArray positionIndices{};
+    SharedArray normalIndices{};
+    SharedArray uvIndices{};
+    SharedArray colorIndices{};
+    SharedArray smoothingGroups{};
+};
+
+struct SharedImage {
+    NameID name  = 0;
+    int width    = 0;
+    int height   = 0;
+    int channels = 0;
+    SharedArray bytes{};
+};
+
+/// @brief Start of every shared segment. Vertex data and materials are copied as they are,
+/// so segments can only be attached by builds with the same layout, which version and
+/// materialSize guard against.
+struct SharedHeader {
+    // written last, a segment is complete once this holds SHARED_MAGIC
+    std::atomic<uint64_t> magic      = 0;
+    std::atomic<uint32_t> references = 0;
+    uint32_t version                 = SHARED_VERSION;
+    uint64_t size                    = 0;
+    uint32_t materialSize            = sizeof(Material);
+    SharedArray name{};
+    SharedArray positions{};
+    SharedArray normals{};
+    SharedArray textureUVs{};
+    SharedArray colors{};
+    SharedArray meshes{};
+    SharedArray materials{};
+    SharedArray images{};
+    SharedArray nameOffsets{};
+    SharedArray nameBytes{};
+};
+#endif
+
+/// @brief Applied to vertex attributes as they are parsed, see OBJLoader::setTransform.
+struct VertexTransform {
+    std::optional<Mat4> matrix       = std::nullopt;
+    std::optional<Mat4> normalMatrix = std::nullopt;
+    bool flipUVs                     = false;
+
+    void set(const Mat4& transform);
+    void apply(Vec3& position) const;
+    void applyNormal(Vec3& normal) const;
+    void apply(Vec2& uv) const;
+};
+
 template <typename K, typename V> std::vector<V> values(const std::unordered_map<K, V>& map)
 {
     std::vector<V> vec{};
@@ -144,6 +628,67 @@ template <typename K, typename V> std::vector<V> values(const std::unordered_map
     return vec;
 }
 
+template <typename T> MemoryUsage memoryUsage(const std::vector<T>& vec)
+{
+    return { vec.size() * sizeof(T), vec.capacity() * sizeof(T) };
+}
+
+/// @brief push_back that reports a reallocation, the old and the new buffer are both alive
+/// while the elements move over.
+template <typename T, typename U>
+void trackedPush(std::vector<T>& vec, U&& value, MemoryTracker& memory)
+{
+    if (vec.size() < vec.capacity()) {
+        vec.push_back(std::forward<U>(value));
+        return;
+    }
+    const size_t before = vec.capacity() * sizeof(T);
+    vec.push_back(std::forward<U>(value));
+    memory.allocate(vec.capacity() * sizeof(T));
+    memory.release(before);
+}
+
+/// @brief shrink_to_fit that reports the copy it makes.
+template <typename T> void trackedShrink(std::vector<T>& vec, MemoryTracker& memory)
+{
+    if (vec.size() == vec.capacity()) return;
+    const size_t before = vec.capacity() * sizeof(T);
+    memory.allocate(vec.size() * sizeof(T));
+    vec.shrink_to_fit();
+    memory.release(before);
+}
+
+inline size_t faceIndexBytes(const Face& face)
+{
+    return (face.positionIndices.capacity() + face.normalIndices.capacity() +
+            face.uvIndices.capacity() + face.colorIndices.capacity()) *
+           sizeof(uint32_t);
+}
+
+inline MemoryUsage memoryUsage(const std::string& str)
+{
+    // short strings live inside the object itself
+    const auto* object = reinterpret_cast<const char*>(&str);
+    if (str.data() >= object && str.data() < object + sizeof(str)) return {};
+    return { str.size() + 1, str.capacity() + 1 };
+}
+
+/// @brief Estimate assuming one heap node per element (value and next pointer, plus the
+/// cached hash where the standard library keeps one) and one pointer per bucket.
+template <typename K, typename V, typename H>
+MemoryUsage memoryUsage(const std::unordered_map<K, V, H>& map)
+{
+    const size_t node    = sizeof(std::pair<const K, V>) + 2 * sizeof(void*);
+    const size_t buckets = map.bucket_count() * sizeof(void*);
+    return { map.size() * node + buckets, map.size() * node + buckets };
+}
+
+// groups and smoothing runs
+MemoryUsage meshMemoryUsage(const Mesh& mesh);
+// Face array and index vectors
+MemoryUsage faceMemoryUsage(const Mesh& mesh);
+MemoryUsage imageMemoryUsage(const std::vector<ImageData>& images);
+
 template <typename K, typename V> std::vector<V> stealValues(std::unordered_map<K, V>& map)
 {
     std::vector<V> vec{};
@@ -174,11 +719,330 @@ public:
     void clear();
 
 private:
+    // loaders running on other threads share the same logger
+    mutable std::mutex m_mutex{};
     std::vector<std::string> m_errors{};
     std::vector<std::string> m_warnings{};
     std::vector<std::string> m_infos{};
 };
 
+/// @brief Lock free log-linear histogram in the style of HdrHistogram. Every power of two is
+/// split into 16 buckets, so reported values are within 6.25% of the recorded ones.
+class Histogram
+{
+public:
+    void record(uint64_t value);
+    uint64_t count() const;
+    uint64_t sum() const;
+    uint64_t max() const;
+    /// @brief Highest value equivalent to the given percentile in [0, 100].
+    uint64_t percentile(double percentile) const;
+    void reset();
+
+private:
+    static constexpr size_t SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKETS     = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t NUM_BUCKETS     = 64 * SUB_BUCKETS;
+
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> m_buckets{};
+    std::atomic<uint64_t> m_count = 0;
+    std::atomic<uint64_t> m_sum   = 0;
+    std::atomic<uint64_t> m_max   = 0;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+};
+
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum   = 0;
+    uint64_t max   = 0;
+    uint64_t p50   = 0;
+    uint64_t p95   = 0;
+    uint64_t p99   = 0;
+};
+
+struct MetricsSnapshot {
+    uint64_t loads          = 0;
+    uint64_t failedLoads    = 0;
+    uint64_t bytes          = 0;
+    uint64_t faces          = 0;
+    uint64_t textures       = 0;
+    uint64_t failedTextures = 0;
+    HistogramSnapshot loadMicroseconds{};
+    HistogramSnapshot bytesPerSecond{};
+    HistogramSnapshot facesPerSecond{};
+    HistogramSnapshot textureDecodeMicroseconds{};
+};
+
+/// @brief Process wide load statistics across all loaders, updated on every load.
+class Metrics
+{
+public:
+    static Metrics& instance();
+
+    void recordLoad(std::chrono::steady_clock::duration duration, uint64_t bytes, uint64_t faces,
+                    bool success);
+    void recordTextureDecode(std::chrono::steady_clock::duration duration, bool success);
+
+    MetricsSnapshot snapshot() const;
+    /// @brief Writes the current snapshot in the OpenMetrics text format.
+    bool writeOpenMetrics(const std::string& filePath) const;
+    void reset();
+
+private:
+    std::atomic<uint64_t> m_loads          = 0;
+    std::atomic<uint64_t> m_failedLoads    = 0;
+    std::atomic<uint64_t> m_bytes          = 0;
+    std::atomic<uint64_t> m_faces          = 0;
+    std::atomic<uint64_t> m_textures       = 0;
+    std::atomic<uint64_t> m_failedTextures = 0;
+    Histogram m_loadMicroseconds{};
+    Histogram m_bytesPerSecond{};
+    Histogram m_facesPerSecond{};
+    Histogram m_textureDecodeMicroseconds{};
+
+    Metrics() = default;
+};
+
+/// @brief Records begin and end of sobj's load stages per thread and writes them as Chrome
+/// trace event json, which can be opened in Perfetto or chrome://tracing. Every thread
+/// writes into its own ring buffer without locking, so keep tracing disabled while a
+/// trace is being written. Buffers of exited threads keep their events and are reused by the
+/// next thread that records. Disabled by default.
+class Tracer
+{
+public:
+    static Tracer& instance();
+
+    void enable();
+    void disable();
+    bool enabled() const;
+
+    /// @brief Records a span, name must outlive the tracer (usually a literal).
+    void record(const char* name, std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end);
+    bool writeChromeTrace(const std::string& filePath) const;
+    /// @brief Summed duration of the recorded spans per name, sorted by name.
+    std::vector<std::pair<std::string_view, std::chrono::steady_clock::duration>> totals() const;
+    /// @brief Drops everything recorded so far. Safe while threads are recording, their spans
+    /// that end afterwards are kept.
+    void clear();
+
+private:
+    static constexpr size_t CAPACITY = 1 << 14;
+
+    struct Event {
+        const char* name = nullptr;
+        std::chrono::steady_clock::time_point begin{};
+        std::chrono::steady_clock::time_point end{};
+    };
+
+    struct ThreadBuffer {
+        uint32_t threadID = 0;
+        std::array<Event, CAPACITY> events{};
+        std::atomic<uint64_t> written = 0;
+        // events before this were cleared, guarded by the mutex so clear() never races writers
+        uint64_t cleared = 0;
+
+        uint64_t firstEvent(uint64_t written) const;
+    };
+
+    std::atomic<bool> m_enabled = false;
+    std::chrono::steady_clock::time_point m_epoch = std::chrono::steady_clock::now();
+    // only guards registering and releasing threads
+    mutable std::mutex m_mutex{};
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers{};
+    // buffers of exited threads
+    std::vector<ThreadBuffer*> m_free{};
+
+    Tracer() = default;
+    ThreadBuffer& threadBuffer();
+    void release(ThreadBuffer& buffer);
+};
+
+namespace detail
+{
+/// @brief Reports a load to Metrics when it goes out of scope, whichever way load() returns.
+struct LoadRecord {
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    uint64_t bytes = 0;
+    uint64_t faces = 0;
+    bool success   = false;
+
+    ~LoadRecord();
+};
+
+/// @brief Records a span from construction until end() or destruction.
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name);
+    ~TraceScope();
+    TraceScope(const TraceScope&)            = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    void end();
+
+private:
+    const char* m_name = nullptr;
+    std::chrono::steady_clock::time_point m_begin{};
+};
+} // namespace detail
+
+/// @brief Runs all of sobj's parallel work. Implement submit and wait to run it on your own
+/// scheduler, otherwise the built-in ThreadPool from defaultExecutor() is used.
+class Executor
+{
+public:
+    virtual ~Executor() = default;
+
+    /// @brief Runs the task at some later point, possibly on another thread.
+    virtual void submit(std::function<void()> task) = 0;
+    /// @brief Calls fn for every index in [0, count) and returns once all calls finished.
+    /// The calling thread helps out, so this is safe to call from inside a submitted task.
+    virtual void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+    /// @brief Blocks until every submitted task has finished.
+    virtual void wait() = 0;
+    /// @brief Number of threads that can run parallelFor work at once, including the caller.
+    /// Sizes the helper count and the block size of parallelFor.
+    virtual size_t concurrency() const;
+};
+
+class ThreadPool final : public Executor
+{
+public:
+    explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency());
+    ~ThreadPool() override;
+
+    void submit(std::function<void()> task) override;
+    void wait() override;
+    /// @brief The pool threads plus the thread calling parallelFor.
+    size_t concurrency() const override;
+    size_t numThreads() const;
+
+private:
+    std::vector<std::thread> m_threads{};
+    std::deque<std::function<void()>> m_tasks{};
+    std::mutex m_mutex{};
+    std::condition_variable m_taskAvailable{};
+    std::condition_variable m_idle{};
+    size_t m_running = 0;
+    bool m_stopping  = false;
+
+    void work();
+};
+
+/// @brief Process wide pool, only created on first use.
+std::shared_ptr<Executor> defaultExecutor();
+
+/// @brief Destroys OBJData in a task on the executor, so dropping a large asset does not
+/// stall the caller. Large attribute buffers are kept for loaders that use this reclaimer,
+/// which then fill them instead of growing new ones.
+class Reclaimer
+{
+public:
+    /// @brief nullptr selects defaultExecutor(). The destructor waits for the queued task, so
+    /// do not destroy the reclaimer from a task of an executor without any other thread.
+    explicit Reclaimer(size_t maxPooledBytes            = detail::DEFAULT_POOL_SIZE,
+                       std::shared_ptr<Executor> executor = nullptr);
+    ~Reclaimer();
+    Reclaimer(const Reclaimer&)            = delete;
+    Reclaimer& operator=(const Reclaimer&) = delete;
+
+    /// @brief Returns immediately, the data is destroyed later on the executor.
+    void reclaim(OBJData&& data);
+    /// @brief Blocks until everything handed to reclaim() so far has been destroyed, the
+    /// calling thread helps with whatever the task has not started on yet.
+    void wait();
+
+    /// @brief Swaps the largest pooled buffer into an empty buffer without capacity, does
+    /// nothing otherwise.
+    void reuse(std::vector<Vec3>& buffer);
+    void reuse(std::vector<Vec2>& buffer);
+    size_t pooledBytes() const;
+
+private:
+    std::shared_ptr<Executor> m_executor = nullptr;
+    std::deque<OBJData> m_queue{};
+    mutable std::mutex m_mutex{};
+    std::condition_variable m_idle{};
+    size_t m_reclaiming = 0;
+    // a task is submitted to the executor and has not finished yet
+    bool m_scheduled = false;
+
+    std::vector<std::vector<Vec3>> m_vec3Pool{};
+    std::vector<std::vector<Vec2>> m_vec2Pool{};
+    size_t m_maxPooledBytes = 0;
+    size_t m_pooledBytes    = 0;
+
+    void work();
+    void drain(std::unique_lock<std::mutex>& lock);
+    template <typename T> void keep(std::vector<std::vector<T>>& pool, std::vector<T>&& buffer);
+    template <typename T> void take(std::vector<std::vector<T>>& pool, std::vector<T>& buffer);
+};
+
+namespace detail
+{
+/// @brief Indicates what the type of the line in the mtl file is.
+enum class MTLIdentifier {
+    NEW_MATERIAL,  // newmtl
+                   //
+    AMBIENT_MAP,   // map_Ka
+    DIFFUSE_MAP,   // map_Kd
+    SPECULAR_MAP,  // map_Ks
+    ROUGHNESS_MAP, // map_Ns
+    ALPHA_MAP,     // map_d
+                   //
+    AMBIENT,       // Ka
+    DIFFUSE,       // Kd
+    SPECULAR,      // Ks
+    ROUGHNESS,     // Ns
+    ALPHA,         // d
+                   //
+    COMMENT,       // #
+    BLANK,         // empty line
+    UNKNOWN,       // ????
+};
+
+/// @brief Indicates what the type of the line in the obj file is.
+enum class OBJIdentifier {
+    POSITION,       // v
+    NORMAL,         // vn
+    UV,             // vt
+    FACE,           // f
+    GROUP,          // g
+    NAMED_OBJECT,   // o
+    SMOOTH_SHADING, // s
+    MATERIAL_LIB,   // mtllib
+    USE_MATERIAL,   // usemtl
+    COMMENT,        // #
+    BLANK,          // empty line
+    UNKNOWN,        // ????
+};
+
+/// @brief Number of elements read so far, negative face indices count back from them.
+struct ElementCounts {
+    size_t positions = 0;
+    size_t normals   = 0;
+    size_t uvs       = 0;
+};
+
+/// @brief Indices of an f line, unified is false once a corner's indices differ.
+struct ParsedFace {
+    Face face{};
+    bool unified = true;
+};
+
+MTLIdentifier mtlIdentifier(std::string_view str);
+OBJIdentifier objIdentifier(std::string_view str);
+/// @brief Parses an f line, wrong separators are logged with filePath and line.
+ParsedFace parseFace(const std::string& str, const ElementCounts& counts, sobjLogger& logger,
+                     std::string_view filePath, size_t line);
+/// @brief Splits a quad into two tris, tris are returned as they are.
+std::vector<Face> triangulate(const Face& face);
+} // namespace detail
+
 class MathParser
 {
 public:
@@ -193,60 +1057,52 @@ public:
 class MTLLoader
 {
 public:
-    MTLLoader(const std::shared_ptr<sobjLogger>& logger) : m_logger(logger)
+    MTLLoader(const std::shared_ptr<sobjLogger>& logger,
+              const std::shared_ptr<Executor>& executor = nullptr)
+        : m_logger(logger), m_executor(executor ? executor : defaultExecutor())
     {
     }
     ~MTLLoader() = default;
 
     bool loadMaterialFile(const std::string& filePath);
     void reset();
+    /// @brief Decoded images are reported to memory, see OBJLoader::peakMemory.
+    void setMemoryTracker(std::shared_ptr<MemoryTracker> memory);
 
     std::vector<Material> stealMaterials();
     std::vector<ImageData> stealImages();
-    std::unordered_map<std::string, uint32_t> materialNameToIndex();
+    NamePool stealNames();
+    std::unordered_map<NameID, uint32_t> materialNameToIndex();
 
 private:
-    /// @brief Indicates what the type of the line in the mtl file is.
-    enum class Identifier {
-        NEW_MATERIAL,  // newmtl
-                       //
-        AMBIENT_MAP,   // map_Ka
-        DIFFUSE_MAP,   // map_Kd
-        SPECULAR_MAP,  // map_Ks
-        ROUGHNESS_MAP, // map_Ns
-        ALPHA_MAP,     // map_d
-                       //
-        AMBIENT,       // Ka
-        DIFFUSE,       // Kd
-        SPECULAR,      // Ks
-        ROUGHNESS,     // Ns
-        ALPHA,         // d
-                       //
-        COMMENT,       // #
-        BLANK,         // empty line
-        UNKNOWN,       // ????
-    };
+    using Identifier = detail::MTLIdentifier;
 
     MathParser m_mathParser{};
 
     std::vector<Material> m_materials{};
     std::vector<ImageData> m_images{};
-    std::unordered_map<std::string, uint32_t> m_loadedImageToIndex{};
-    std::unordered_map<std::string, uint32_t> m_materialNameToIndex{};
+    // images are decoded in parallel once the whole file has been parsed
+    std::vector<std::string> m_imagePaths{};
+    NamePool m_names{};
+    std::unordered_map<NameID, uint32_t> m_loadedImageToIndex{};
+    std::unordered_map<NameID, uint32_t> m_materialNameToIndex{};
 
     std::string m_filePath{};
     std::string m_workingDirectory{};
     size_t m_line = 0;
 
-    std::shared_ptr<sobjLogger> m_logger = nullptr;
+    std::shared_ptr<sobjLogger> m_logger     = nullptr;
+    std::shared_ptr<Executor> m_executor    = nullptr;
+    std::shared_ptr<MemoryTracker> m_memory = nullptr;
 
+    bool parseMaterialFile(const std::string& filePath);
+    void decodeImages();
     bool parseNewMaterial(const std::string& str);
     std::optional<uint32_t> parseImage(const std::string& str);
 
     bool setImageMap(std::optional<uint32_t>& imageMapIndex, const std::string& line,
                      Identifier identifier);
 
-    Identifier identifier(std::string_view str) const;
     std::string toString(Identifier identifier) const;
     bool materialExists() const;
 };
@@ -258,11 +1114,32 @@ public:
     ~OBJLoader() = default;
 
     bool load(const std::string& filePath);
+    /// @brief Only looks at the keyword of each line to list names and count elements.
+    /// No numbers are parsed and no textures are decoded. Clears previous messages.
+    std::optional<OBJSummary> scan(const std::string& filePath);
 
     void setShouldTriangulate(bool b);
+    /// @brief Called on the loading thread for every mesh as soon as the next g or o line
+    /// (or the end of the file) is reached.
+    void setMeshCallback(MeshCallback callback);
+    /// @brief Executor used for all parallel work, nullptr selects defaultExecutor().
+    void setExecutor(std::shared_ptr<Executor> executor);
+    /// @brief Attribute buffers are taken from the reclaimer's pool and keep their spare
+    /// capacity, so they can go back into the pool once the data is reclaimed.
+    void setReclaimer(std::shared_ptr<Reclaimer> reclaimer);
+    /// @brief Applied to positions while parsing, normals get the inverse transpose.
+    void setTransform(const Mat4& transform);
+    /// @brief Stores v as 1 - v, matching stbi_set_flip_vertically_on_load.
+    void setFlipUVs(bool b);
 
     OBJData steal();
     OBJData share() const;
+    /// @brief Most heap memory the last load() held at once, 0 if that load failed. Counts
+    /// attribute, face and mesh buffers including the overlap while they grow or shrink,
+    /// names, and decoded images including their staging copy, also while their material
+    /// libraries are still loading. Materials, lookup tables and read buffers are small and
+    /// left out.
+    size_t peakMemory() const;
 
     std::vector<std::string> getErrors() const;
     std::vector<std::string> getWarnings() const;
@@ -271,29 +1148,13 @@ public:
     bool existsWarning() const;
 
 private:
-    /// @brief Indicates what the type of the line in the obj file is.
-    enum class Identifier {
-        POSITION,       // v
-        NORMAL,         // vn
-        UV,             // vt
-        FACE,           // f
-        GROUP,          // g
-        NAMED_OBJECT,   // o
-        SMOOTH_SHADING, // s
-        MATERIAL_LIB,   // mtllib
-        USE_MATERIAL,   // usemtl
-        COMMENT,        // #
-        BLANK,          // empty line
-        UNKNOWN,        // ????
-    };
+    using Identifier = detail::OBJIdentifier;
 
-    /// @brief Used when calculating index to determine which vector is relevant
-    enum class IndexType {
-        POSITION, // m_positions
-        NORMAL,   // m_normals
-        UV,       // m_textureUVs
-        COLOR,    // m_colors
-        FACE      // ???
+    /// @brief Result of a material library parsed alongside the obj geometry.
+    struct MaterialLibrary {
+        std::vector<Material> materials{};
+        std::vector<ImageData> images{};
+        NamePool names{};
     };
 
     struct Config {
@@ -302,15 +1163,21 @@ private:
             NONE,
         };
         bool triangulate = true;
+        MeshCallback meshCallback{};
+        detail::VertexTransform transform{};
     };
 
     Config m_config{};
 
-    std::shared_ptr<sobjLogger> m_logger = std::make_shared<sobjLogger>();
+    std::shared_ptr<sobjLogger> m_logger   = std::make_shared<sobjLogger>();
+    std::shared_ptr<Executor> m_executor   = nullptr;
+    std::shared_ptr<Reclaimer> m_reclaimer = nullptr;
 
     uint32_t m_line = 0;
-    std::string m_currentMeshName{};
-    bool m_smoothShadingEnabled = false;
+    NameID m_currentMeshName = 0;
+    uint32_t m_smoothingGroup = 0;
+    size_t m_peakMemory = 0;
+    std::shared_ptr<MemoryTracker> m_memory = std::make_shared<MemoryTracker>();
 
     std::vector<Vec3> m_positions{};
     std::vector<Vec3> m_normals{};
@@ -320,647 +1187,4795 @@ private:
     std::vector<Mesh> m_meshes{};
     std::vector<Material> m_materials{};
     std::vector<ImageData> m_images{};
-    std::unordered_map<std::string, uint32_t> m_materialNameToIndex{};
+    NamePool m_names{};
+    std::unordered_map<NameID, uint32_t> m_materialNameToIndex{};
+    // mtllib files are parsed concurrently, usemtl is resolved once they have all finished
+    std::vector<std::shared_ptr<detail::ClaimableTask<MaterialLibrary>>> m_materialLibraries{};
+    std::vector<std::pair<size_t, NameID>> m_pendingMaterials{};
+    // set by usemtl, bound to the next mesh that receives faces
+    std::optional<NameID> m_currentMaterial = std::nullopt;
 
     std::string m_filePath{};
     std::string m_workingDirectory{};
 
     MathParser m_mathParser{};
-    MTLLoader m_mtlLoader{ m_logger };
 
     std::optional<Face> parseFace(const std::string& str);
     void parseSmoothShading(const std::string& str);
     void parseGroup(const std::string& str);
+    void parseNamedObject(const std::string& str);
     std::optional<std::string> parseMaterialFilePath(const std::string& str) const;
     bool parseUseMaterial(const std::string& str);
+    void loadMaterialLibrary(const std::string& filePath);
+    void resolveMaterials();
+    void discardMaterialLibraries();
 
-    Identifier identifier(std::string_view str) const;
     std::string toString(Identifier id) const;
-    size_t calculateIndex(int index, IndexType type) const;
     void pushFace(const Face& face);
     void pushFaces(const std::vector<Face>& faces);
-    std::vector<Face> triangulate(const Face& face) const;
     void shrink();
-    void makeGroup(const std::string& name);
-    void makeGroupAnonym();
+    void makeGroup(NameID name, std::vector<NameID> groups = {});
+    void pushSmoothingGroup(Mesh& mesh) const;
+    void publishMesh(size_t meshIndex) const;
+    std::shared_ptr<Executor> executor() const;
+    Mesh& currentMesh();
+    /// @brief Binds the material of the last usemtl to the current mesh.
+    void bindMaterial();
+    /// @brief m_names.intern that reports the growth of the pool.
+    NameID intern(std::string_view name);
 
     void reset();
 };
 
-#ifdef SOBJ_IMPLEMENTATION
-//--------------------------------------------------
-// MARK: MTLLoader Parsing methods
-//--------------------------------------------------
-bool MTLLoader::loadMaterialFile(const std::string& filePath)
+/// @brief Loads ascii and binary ply files into the same OBJData layout OBJLoader produces.
+/// Reads x/y/z, nx/ny/nz, red/green/blue and u/v (or s/t) vertex properties and the
+/// vertex_indices list of faces into a single mesh. Every attribute uses the vertex index.
+class PLYLoader
 {
-    m_filePath = filePath;
-    detail::trim(m_filePath);
+public:
+    PLYLoader()  = default;
+    ~PLYLoader() = default;
 
-    if (!m_filePath.ends_with(".mtl")) { return false; }
+    bool load(const std::string& filePath);
 
-    std::filesystem::path objPath = m_filePath;
-    m_workingDirectory            = objPath.parent_path().string() + "/";
+    void setShouldTriangulate(bool b);
+    /// @brief Executor used for all parallel work, nullptr selects defaultExecutor().
+    void setExecutor(std::shared_ptr<Executor> executor);
+    /// @brief See OBJLoader::setReclaimer.
+    void setReclaimer(std::shared_ptr<Reclaimer> reclaimer);
+    /// @brief Applied to positions while loading, normals get the inverse transpose.
+    void setTransform(const Mat4& transform);
+    /// @brief Stores v as 1 - v, matching stbi_set_flip_vertically_on_load.
+    void setFlipUVs(bool b);
 
-    std::ifstream file;
+    OBJData steal();
+
+    std::vector<std::string> getErrors() const;
+    std::vector<std::string> getWarnings() const;
+    std::vector<std::string> getInfos() const;
+    bool existsError() const;
+    bool existsWarning() const;
+
+private:
+    enum class Format {
+        ASCII,                // format ascii 1.0
+        BINARY_LITTLE_ENDIAN, // format binary_little_endian 1.0
+        BINARY_BIG_ENDIAN,    // format binary_big_endian 1.0
+    };
+
+    enum class PropertyType { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+    struct Property {
+        std::string name{};
+        PropertyType type      = PropertyType::FLOAT32;
+        bool isList            = false;
+        PropertyType countType = PropertyType::UINT8;
+    };
+
+    struct Element {
+        std::string name{};
+        size_t count = 0;
+        std::vector<Property> properties{};
+    };
+
+    /// @brief Where the rows of an element start in the binary body.
+    struct Rows {
+        size_t begin  = 0;
+        size_t stride = 0; // 0 if rows contain lists and starts is used instead
+        std::vector<size_t> starts{};
+        size_t end = 0;
+
+        size_t start(const size_t row) const
+        {
+            return stride ? begin + row * stride : starts[row];
+        }
+    };
+
+    struct Config {
+        bool triangulate = true;
+        detail::VertexTransform transform{};
+    };
+
+    Config m_config{};
+
+    std::shared_ptr<sobjLogger> m_logger   = std::make_shared<sobjLogger>();
+    std::shared_ptr<Executor> m_executor   = nullptr;
+    std::shared_ptr<Reclaimer> m_reclaimer = nullptr;
+
+    Format m_format = Format::ASCII;
+    std::vector<Element> m_elements{};
+
+    std::vector<Vec3> m_positions{};
+    std::vector<Vec3> m_normals{};
+    std::vector<Vec2> m_textureUVs{};
+    std::vector<Vec3> m_colors{};
+    std::vector<Mesh> m_meshes{};
+    NamePool m_names{};
+
+    std::string m_filePath{};
+
+    bool parseHeader(std::string_view& data);
+    bool parseBinary(std::string_view data);
+    bool parseASCII(std::string_view data);
+    bool findRows(const Element& element, std::string_view data, size_t offset, bool swap,
+                  Rows& rows) const;
+    void readVertices(const Element& element, std::string_view data, const Rows& rows, bool swap);
+    void transformVertices();
+    bool readFaces(const Element& element, std::string_view data, const Rows& rows, bool swap);
+    void pushFaces(std::vector<Face> faces);
+
+    std::optional<PropertyType> propertyType(std::string_view str) const;
+    static size_t typeSize(PropertyType type);
+    static double readValue(const char* ptr, PropertyType type, bool swap);
+    /// @brief Integer colors are normalized to [0, 1].
+    static double colorScale(PropertyType type);
+    void warnSkippedFaces(size_t truncated, size_t degenerate) const;
+    Face makeFace(std::span<const uint32_t> indices) const;
+    /// @brief Faces may come before the vertices, so their indices are only checked and their
+    /// attributes only attached once every element has been read.
+    bool finishFaces();
+    std::shared_ptr<Executor> executor() const;
+    void shrink();
+
+    void reset();
+};
+
+#ifdef SOBJ_POSIX
+/// @brief A mesh inside a SharedOBJData. Face i uses the entries [faceOffsets[i],
+/// faceOffsets[i + 1]) of the index arrays. Attributes a face does not have are stored as
+/// UINT32_MAX, index arrays that no face of the mesh uses are empty.
+struct SharedMeshView {
+    std::string_view name{};
+    std::span<const NameID> groups{};
+    std::optional<uint32_t> materialIndex = std::nullopt;
+    bool unifiedIndices                   = true;
+    std::span<const uint32_t> faceOffsets{};
+    std::span<const uint32_t> positionIndices{};
+    std::span<const uint32_t> normalIndices{};
+    std::span<const uint32_t> uvIndices{};
+    std::span<const uint32_t> colorIndices{};
+    std::span<const SmoothingRun> smoothingGroups{};
+
+    size_t numFaces() const
+    {
+        return faceOffsets.empty() ? 0 : faceOffsets.size() - 1;
+    }
+};
+
+struct SharedImageView {
+    std::string_view name{};
+    std::span<const unsigned char> bytes{};
+    int width    = 0;
+    int height   = 0;
+    int channels = 0;
+};
+
+/// @brief OBJData published into a named POSIX shared memory segment. The segment only holds
+/// offsets, so every process maps it read only wherever it likes and reads it in place.
+/// Each handle holds a reference, the segment is unlinked when the last one is released.
+/// References of processes that die without releasing them are never returned.
+class SharedOBJData
+{
+public:
+    /// @brief Copies the data into a new segment, name is passed to shm_open and fails if
+    /// a segment with that name exists already. The segment gets exactly mode, regardless of
+    /// the umask. The reference count lives in the segment, so attaching needs read and
+    /// write permission, e.g. 0660 to share with processes of the same group.
+    static std::optional<SharedOBJData> publish(const OBJData& data, const std::string& name,
+                                                mode_t mode = 0600);
+    /// @brief Fails if the segment does not exist or the process may not read and write it.
+    static std::optional<SharedOBJData> attach(const std::string& name);
+
+    SharedOBJData(SharedOBJData&& other) noexcept;
+    SharedOBJData& operator=(SharedOBJData&& other) noexcept;
+    SharedOBJData(const SharedOBJData&)            = delete;
+    SharedOBJData& operator=(const SharedOBJData&) = delete;
+    ~SharedOBJData();
+
+    std::string_view name() const;
+    std::span<const Vec3> positions() const;
+    std::span<const Vec3> normals() const;
+    std::span<const Vec2> textureUVs() const;
+    std::span<const Vec3> colors() const;
+    std::span<const Material> materials() const;
+    size_t numMeshes() const;
+    SharedMeshView mesh(size_t index) const;
+    size_t numImages() const;
+    SharedImageView image(size_t index) const;
+    /// @brief Name of a mesh, group, material or image.
+    std::string_view name(NameID id) const;
+    size_t size() const;
+
+private:
+    std::string m_segmentName{};
+    const char* m_data             = nullptr; // read only mapping of the whole segment
+    detail::SharedHeader* m_header = nullptr; // writable mapping for the reference count
+    size_t m_size                  = 0;
+
+    SharedOBJData() = default;
+
+    static std::optional<SharedOBJData> map(int fd, const std::string& name);
+    template <typename T> std::span<const T> array(const detail::SharedArray& array) const;
+    void release();
+};
+#endif
+
+struct Neighbor {
+    uint32_t index         = 0; // into the points the tree was built from
+    float distanceSquared = 0.0f;
+};
+
+/// @brief Implicit k-d tree for nearest neighbour queries on a point set such as
+/// OBJData::positions. Points are copied in tree order, each range is split at its median
+/// along its widest axis and small ranges become leaves that are scanned with SIMD.
+class KDTree
+{
+public:
+    KDTree() = default;
+    /// @brief The top of the tree is built in parallel, nullptr selects defaultExecutor().
+    explicit KDTree(std::span<const Vec3> points,
+                    const std::shared_ptr<Executor>& executor = nullptr);
+
+    /// @brief The k closest points, closest first.
+    std::vector<Neighbor> nearest(const Vec3& query, size_t k) const;
+    /// @brief All points within the radius, closest first.
+    std::vector<Neighbor> withinRadius(const Vec3& query, float radius) const;
+
+    /// @brief Runs one nearest() per query in parallel. Row i of the result holds the
+    /// neighbours of query i, fewer than k if the tree has less points.
+    std::vector<std::vector<Neighbor>> nearest(
+        std::span<const Vec3> queries, size_t k,
+        const std::shared_ptr<Executor>& executor = nullptr) const;
+    std::vector<std::vector<Neighbor>> withinRadius(
+        std::span<const Vec3> queries, float radius,
+        const std::shared_ptr<Executor>& executor = nullptr) const;
+
+    size_t size() const;
+
+private:
+    static constexpr size_t LEAF_SIZE = 16;
+    // ranges above this many points are split on two threads
+    static constexpr size_t PARALLEL_BUILD_SIZE = 64 * 1024;
+
+    // coordinates in tree order, the median of a range [begin, end) sits at its middle
+    std::vector<float> m_x{};
+    std::vector<float> m_y{};
+    std::vector<float> m_z{};
+    std::vector<uint32_t> m_indices{};
+    // split axis of the node at every middle, unused inside leaves
+    std::vector<uint8_t> m_axes{};
+
+    void build(std::span<const Vec3> points, size_t begin, size_t end, Executor& executor);
+    template <typename Visit>
+    void search(const Vec3& query, size_t begin, size_t end, const float& maxDistanceSquared,
+                Visit& visit) const;
+    float coordinate(size_t index, uint8_t axis) const;
+};
+
+/// @brief Builds a vertex buffer for a single mesh of the given data. Meshes with unified
+/// indices are gathered through a table over their index range, all others are welded by
+/// hashing their position/uv/normal index triples. Either way only referenced vertices and
+/// attributes the faces have indices for end up in the buffer.
+VertexBuffer buildVertexBuffer(const OBJData& data, const Mesh& mesh);
+/// @brief Builds the vertex buffers of all meshes in parallel, nullptr selects
+/// defaultExecutor().
+std::vector<VertexBuffer> buildVertexBuffers(const OBJData& data,
+                                             const std::shared_ptr<Executor>& executor = nullptr);
+/// @brief Copies a mesh together with only the attributes it uses, so it can be uploaded
+/// without gathering from the shared arrays. Unified meshes stay unified.
+LocalMesh buildLocalMesh(const OBJData& data, const Mesh& mesh);
+/// @brief Builds the local meshes of all meshes in parallel, nullptr selects
+/// defaultExecutor().
+std::vector<LocalMesh> buildLocalMeshes(const OBJData& data,
+                                        const std::shared_ptr<Executor>& executor = nullptr);
+/// @brief Heap memory owned by the given data, broken down by container.
+MemoryFootprint memoryFootprint(const OBJData& data);
+
+struct AmbientOcclusionSettings {
+    uint32_t rayCount = 64;
+    // occluders further away than this do not count
+    float maxDistance = 1.0f;
+    // rays start this far along the vertex normal to not hit their own faces
+    float bias    = 1e-4f;
+    uint32_t seed = 0;
+};
+
+/// @brief Bakes per vertex ambient occlusion into OBJData::colors, one grey value per
+/// position where 1 is fully unoccluded, and points the color indices of every face at them.
+/// Rays are cosine distributed around the averaged face normal and traced against all
+/// meshes in packets of four through a BVH. Positions no face uses stay white.
+void bakeAmbientOcclusion(OBJData& data, const AmbientOcclusionSettings& settings = {},
+                          const std::shared_ptr<Executor>& executor = nullptr);
+
+struct RepairSettings {
+    bool orientFaces = true;
+    bool fillHoles   = true;
+    // boundary loops with more edges than this are left open
+    size_t maxHoleSize = 8;
+};
+
+/// @brief What repair changed, summed over all meshes.
+struct RepairReport {
+    size_t components    = 0;
+    size_t flippedFaces  = 0;
+    size_t filledHoles   = 0;
+    size_t addedFaces    = 0;
+    size_t skippedHoles  = 0; // loops above maxHoleSize or touching a non-manifold vertex
+    // components without any consistent orientation, for example a moebius strip
+    size_t nonOrientableComponents = 0;
+    // edges shared by more than two faces, they are ignored for orientation and holes
+    size_t nonManifoldEdges = 0;
+};
+
+/// @brief Makes the winding of faces consistent within every connected component of each
+/// mesh and fills small holes. Components are walked with a breadth first search whose
+/// frontier is processed in parallel, the orientation most faces already have wins. Holes
+/// are filled with a fan of triangles that only have position indices, unless the mesh has
+/// unified indices in which case the normal and uv indices are the same as those.
+RepairReport repair(OBJData& data, const RepairSettings& settings = {},
+                    const std::shared_ptr<Executor>& executor = nullptr);
+
+//--------------------------------------------------
+// MARK: Compile-time Parsing
+//--------------------------------------------------
+
+/// @brief String literal usable as a template argument. Also accepts char arrays created
+/// with #embed, a trailing null terminator is optional.
+template <size_t N> struct FixedString {
+    char data[N]{};
+
+    consteval FixedString(const char (&str)[N])
+    {
+        std::copy_n(str, N, data);
+    }
+
+    constexpr std::string_view view() const
+    {
+        if (N > 0 && data[N - 1] == '\0') return { data, N - 1 };
+        return { data, N };
+    }
+};
+
+/// @brief Obj data parsed at compile time. Faces are triangulated the same way OBJLoader
+/// does, with three entries per triangle in each index array. Missing uv or normal indices
+/// are set to UINT32_MAX.
+template <size_t NumPositions, size_t NumNormals, size_t NumUVs, size_t NumIndices>
+struct StaticOBJData {
+    std::array<Vec3, NumPositions> positions{};
+    std::array<Vec3, NumNormals> normals{};
+    std::array<Vec2, NumUVs> textureUVs{};
+    std::array<uint32_t, NumIndices> positionIndices{};
+    std::array<uint32_t, NumIndices> normalIndices{};
+    std::array<uint32_t, NumIndices> uvIndices{};
+};
+
+namespace detail
+{
+struct StaticCounts {
+    size_t positions = 0;
+    size_t normals   = 0;
+    size_t uvs       = 0;
+    size_t indices   = 0;
+};
+
+constexpr bool isSpace(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+constexpr std::string_view trimmed(std::string_view str)
+{
+    while (!str.empty() && isSpace(str.front())) str.remove_prefix(1);
+    while (!str.empty() && isSpace(str.back())) str.remove_suffix(1);
+    return str;
+}
+
+/// @brief Pops the next line off of str and returns it trimmed.
+constexpr std::string_view nextLine(std::string_view& str)
+{
+    const size_t end = str.find('\n');
+    const std::string_view line = str.substr(0, end);
+    str.remove_prefix(end == std::string_view::npos ? str.size() : end + 1);
+    return trimmed(line);
+}
+
+/// @brief Pops the next whitespace separated token off of str.
+constexpr std::string_view nextToken(std::string_view& str)
+{
+    str = trimmed(str);
+    size_t end = 0;
+    while (end < str.size() && !isSpace(str[end])) end++;
+    const std::string_view token = str.substr(0, end);
+    str.remove_prefix(end);
+    return token;
+}
+
+constexpr float parseStaticFloat(const std::string_view str)
+{
+    size_t i      = 0;
+    double sign   = 1.0;
+    double value  = 0.0;
+    bool anyDigit = false;
+    if (i < str.size() && (str[i] == '-' || str[i] == '+')) sign = str[i++] == '-' ? -1.0 : 1.0;
+    for (; i < str.size() && str[i] >= '0' && str[i] <= '9'; i++, anyDigit = true) {
+        value = value * 10.0 + (str[i] - '0');
+    }
+    if (i < str.size() && str[i] == '.') {
+        double scale = 0.1;
+        for (i++; i < str.size() && str[i] >= '0' && str[i] <= '9'; i++, anyDigit = true) {
+            value += (str[i] - '0') * scale;
+            scale *= 0.1;
+        }
+    }
+    if (!anyDigit) throw std::runtime_error("Invalid number in embedded obj");
+    if (i < str.size() && (str[i] == 'e' || str[i] == 'E')) {
+        i++;
+        bool negative = false;
+        if (i < str.size() && (str[i] == '-' || str[i] == '+')) negative = str[i++] == '-';
+        int exponent = 0;
+        for (; i < str.size() && str[i] >= '0' && str[i] <= '9'; i++) {
+            exponent = exponent * 10 + (str[i] - '0');
+        }
+        for (int e = 0; e < exponent; e++) value = negative ? value / 10.0 : value * 10.0;
+    }
+    if (i != str.size()) throw std::runtime_error("Invalid number in embedded obj");
+    return static_cast<float>(sign * value);
+}
+
+constexpr int32_t parseStaticInt(const std::string_view str)
+{
+    size_t i      = 0;
+    bool negative = false;
+    if (i < str.size() && (str[i] == '-' || str[i] == '+')) negative = str[i++] == '-';
+    if (i == str.size()) throw std::runtime_error("Invalid index in embedded obj");
+    int32_t value = 0;
+    for (; i < str.size(); i++) {
+        if (str[i] < '0' || str[i] > '9') throw std::runtime_error("Invalid index in embedded obj");
+        value = value * 10 + (str[i] - '0');
+    }
+    return negative ? -value : value;
+}
+
+/// @brief Resolves a 1 based, possibly negative (relative) obj index.
+constexpr uint32_t resolveStaticIndex(const int32_t index, const size_t count)
+{
+    if (index > 0 && static_cast<size_t>(index) <= count) return index - 1;
+    if (index < 0 && static_cast<size_t>(-index) <= count) return count + index;
+    throw std::runtime_error("Index out of range in embedded obj");
+}
+
+constexpr size_t countTokens(std::string_view str)
+{
+    size_t count = 0;
+    while (!nextToken(str).empty()) count++;
+    return count;
+}
+
+/// @brief Mirrors detail::triangulate, only tris and quads are supported.
+constexpr size_t staticTriangleIndexCount(const size_t numVertices)
+{
+    if (numVertices == 3) return 3;
+    if (numVertices == 4) return 6;
+    throw std::runtime_error("Currently only quads and tris are supported");
+}
+
+constexpr StaticCounts countStatic(std::string_view str)
+{
+    StaticCounts counts{};
+    while (!str.empty()) {
+        std::string_view line = nextLine(str);
+        const std::string_view keyword = nextToken(line);
+        if (keyword == "v") counts.positions++;
+        else if (keyword == "vn") counts.normals++;
+        else if (keyword == "vt") counts.uvs++;
+        else if (keyword == "f") counts.indices += staticTriangleIndexCount(countTokens(line));
+    }
+    return counts;
+}
+
+template <typename Data> constexpr void parseStatic(std::string_view str, Data& data)
+{
+    StaticCounts counts{};
+    while (!str.empty()) {
+        std::string_view line = nextLine(str);
+        const std::string_view keyword = nextToken(line);
+
+        if (keyword == "v" || keyword == "vn") {
+            const Vec3 vec{ parseStaticFloat(nextToken(line)),
+                            parseStaticFloat(nextToken(line)),
+                            parseStaticFloat(nextToken(line)) };
+            if (keyword == "v") data.positions[counts.positions++] = vec;
+            else data.normals[counts.normals++] = vec;
+        } else if (keyword == "vt") {
+            data.textureUVs[counts.uvs++] = { parseStaticFloat(nextToken(line)),
+                                              parseStaticFloat(nextToken(line)) };
+        } else if (keyword == "f") {
+            // v, v/vt, v//vn and v/vt/vn syntax
+            uint32_t positions[4]{};
+            uint32_t uvs[4]{};
+            uint32_t normals[4]{};
+            const size_t numVertices = countTokens(line);
+            staticTriangleIndexCount(numVertices);
+            for (size_t i = 0; i < numVertices; i++) {
+                std::string_view token = nextToken(line);
+                const size_t slash1    = token.find(DELIMITER);
+                const size_t slash2 =
+                    slash1 == std::string_view::npos ? slash1 : token.find(DELIMITER, slash1 + 1);
+
+                positions[i] = resolveStaticIndex(parseStaticInt(token.substr(0, slash1)),
+                                                  counts.positions);
+                uvs[i]       = NO_INDEX;
+                normals[i]   = NO_INDEX;
+                if (slash1 == std::string_view::npos) continue;
+
+                const std::string_view uv = token.substr(slash1 + 1, slash2 - slash1 - 1);
+                if (!uv.empty()) uvs[i] = resolveStaticIndex(parseStaticInt(uv), counts.uvs);
+                if (slash2 != std::string_view::npos) {
+                    const int32_t normal = parseStaticInt(token.substr(slash2 + 1));
+                    normals[i]           = resolveStaticIndex(normal, counts.normals);
+                }
+            }
+
+            // we turn p1 p2 p3 p4 into p1 p2 p3 + p1 p3 p4
+            constexpr size_t order[] = { 0, 1, 2, 0, 2, 3 };
+            for (size_t i = 0; i < staticTriangleIndexCount(numVertices); i++) {
+                data.positionIndices[counts.indices] = positions[order[i]];
+                data.uvIndices[counts.indices]       = uvs[order[i]];
+                data.normalIndices[counts.indices]   = normals[order[i]];
+                counts.indices++;
+            }
+        }
+    }
+}
+} // namespace detail
+
+/// @brief Parses obj source at compile time, e.g.
+/// constexpr auto cube = sobj::embedOBJ<"v 0 0 0\n...">();
+/// Only geometry is supported, groups, materials and smoothing are ignored.
+template <FixedString Source> consteval auto embedOBJ()
+{
+    constexpr detail::StaticCounts counts = detail::countStatic(Source.view());
+    StaticOBJData<counts.positions, counts.normals, counts.uvs, counts.indices> data{};
+    detail::parseStatic(Source.view(), data);
+    return data;
+}
+
+#ifdef SOBJ_IMPLEMENTATION
+//--------------------------------------------------
+// MARK: Parsing Primitives
+//--------------------------------------------------
+
+namespace detail
+{
+MTLIdentifier mtlIdentifier(const std::string_view str)
+{
+    if (str.starts_with("newmtl ")) return MTLIdentifier::NEW_MATERIAL;
+
+    if (str.starts_with("map_Ka ")) return MTLIdentifier::AMBIENT_MAP;
+    if (str.starts_with("map_Kd ")) return MTLIdentifier::DIFFUSE_MAP;
+    if (str.starts_with("map_Ks ")) return MTLIdentifier::SPECULAR_MAP;
+    if (str.starts_with("map_Ns ")) return MTLIdentifier::ROUGHNESS_MAP;
+    if (str.starts_with("map_d ")) return MTLIdentifier::ALPHA_MAP;
+
+    if (str.starts_with("Ka ")) return MTLIdentifier::AMBIENT;
+    if (str.starts_with("Kd ")) return MTLIdentifier::DIFFUSE;
+    if (str.starts_with("Ks ")) return MTLIdentifier::SPECULAR;
+    if (str.starts_with("Ns ")) return MTLIdentifier::ROUGHNESS;
+    if (str.starts_with("d ")) return MTLIdentifier::ALPHA;
+
+    if (str.starts_with("# ")) return MTLIdentifier::COMMENT;
+    if (str.empty()) return MTLIdentifier::BLANK;
+
+    return MTLIdentifier::UNKNOWN;
+}
+
+OBJIdentifier objIdentifier(const std::string_view str)
+{
+    if (str.starts_with("v ")) return OBJIdentifier::POSITION;
+    if (str.starts_with("vn ")) return OBJIdentifier::NORMAL;
+    if (str.starts_with("vt ")) return OBJIdentifier::UV;
+    if (str.starts_with("f ")) return OBJIdentifier::FACE;
+    if (str.starts_with("g ")) return OBJIdentifier::GROUP;
+    if (str.starts_with("o ")) return OBJIdentifier::NAMED_OBJECT;
+    if (str.starts_with("s ")) return OBJIdentifier::SMOOTH_SHADING;
+    if (str.starts_with("mtllib ")) return OBJIdentifier::MATERIAL_LIB;
+    if (str.starts_with("usemtl ")) return OBJIdentifier::USE_MATERIAL;
+    if (str.starts_with("# ")) return OBJIdentifier::COMMENT;
+    if (str.empty())
+        return OBJIdentifier::BLANK; // we trim before this call so it will always be empty
+
+    return OBJIdentifier::UNKNOWN;
+}
+
+/// @brief Resolves a 1 based, possibly negative (relative) obj index.
+inline size_t faceIndex(const int32_t index, const size_t count)
+{
+    // TODO: handle invalid negative indices here as well as positve indieces
+    if (index > 0) return index - 1;
+    return count - std::abs(index);
+}
+
+ParsedFace parseFace(const std::string& str, const ElementCounts& counts, sobjLogger& logger,
+                     const std::string_view filePath, const size_t line)
+{
+    std::stringstream stream{ str };
+    ParsedFace parsed{};
+    Face& face    = parsed.face;
+    bool& unified = parsed.unified;
+    std::string _;
+    stream >> _;
+
+    // v//vn syntax
+    if (str.find("//") != std::string::npos) {
+        int32_t v, vn;
+        char slash1, slash2;
+
+        while (stream >> v >> slash1 >> slash2 >> vn) {
+            if (slash1 != DELIMITER || slash2 != DELIMITER) {
+                logger.error(
+                    std::format("Invalid syntax encountered in file {} at line {} ({} or "
+                                "{} is not \\)",
+                                filePath,
+                                line,
+                                slash1,
+                                slash2));
+            }
+            face.positionIndices.push_back(faceIndex(v, counts.positions));
+            face.normalIndices.push_back(faceIndex(vn, counts.normals));
+            unified = unified && face.positionIndices.back() == face.normalIndices.back();
+        }
+
+        return parsed;
+    }
+
+    if (str.find("/") != std::string::npos) {
+        int32_t v, vt;
+        char slash1;
+        stream >> v >> slash1 >> vt;
+
+        // v/vt/vn syntax
+        if (stream.peek() == DELIMITER) {
+            char slash2;
+            int32_t vn;
+            stream >> slash2 >> vn;
+            do {
+                if (slash1 != DELIMITER || slash2 != DELIMITER) {
+                    logger.error(
+                        std::format("Invalid syntax encountered in file {} at line {} ({} "
+                                    "or {} is not \\)",
+                                    filePath,
+                                    line,
+                                    slash1,
+                                    slash2));
+                }
+                face.positionIndices.push_back(faceIndex(v, counts.positions));
+                face.uvIndices.push_back(faceIndex(vt, counts.uvs));
+                face.normalIndices.push_back(faceIndex(vn, counts.normals));
+                unified = unified && face.positionIndices.back() == face.uvIndices.back() &&
+                          face.positionIndices.back() == face.normalIndices.back();
+            } while (stream >> v >> slash1 >> vt >> slash2 >> vn);
+
+            return parsed;
+        }
+
+        // v/vt syntax
+        do {
+            if (slash1 != DELIMITER) {
+                logger.error(
+                    std::format("Invalid syntax encountered in file {} at line {} ({} is "
+                                "not \\)",
+                                filePath,
+                                line,
+                                slash1));
+            }
+            face.positionIndices.push_back(faceIndex(v, counts.positions));
+            face.uvIndices.push_back(faceIndex(vt, counts.uvs));
+            unified = unified && face.positionIndices.back() == face.uvIndices.back();
+        } while (stream >> v >> slash1 >> vt);
+
+        return parsed;
+    }
+
+    // v1 v2 v3 syntax
+    int32_t v;
+    while (stream >> v) {
+        face.positionIndices.push_back(faceIndex(v, counts.positions));
+    }
+
+    return parsed;
+}
+
+std::vector<Face> triangulate(const Face& face)
+{
+    // TODO: add support for more than 3 or 4 vertices. actual algorithm would be cool :D
+    // already a tri
+    if (face.numVertices() == 3) { return { face }; }
+    if (face.numVertices() != 4) {
+        throw std::runtime_error("Currently only quads and tris are supported");
+    }
+
+    Face f1{};
+    Face f2{};
+    // we turn p1 p2 p3 p4 into p1 p2 p3 + p1 p3 p4
+    constexpr int indices1[] = { 0, 1, 2 };
+    constexpr int indices2[] = { 0, 2, 3 };
+    for (const int i : indices1) {
+        f1.positionIndices.push_back(face.positionIndices[i]);
+        if (!face.normalIndices.empty()) f1.normalIndices.push_back(face.normalIndices[i]);
+        if (!face.colorIndices.empty()) f1.colorIndices.push_back(face.colorIndices[i]);
+        if (!face.uvIndices.empty()) f1.uvIndices.push_back(face.uvIndices[i]);
+    }
+    for (const int i : indices2) {
+        f2.positionIndices.push_back(face.positionIndices[i]);
+        if (!face.normalIndices.empty()) f2.normalIndices.push_back(face.normalIndices[i]);
+        if (!face.colorIndices.empty()) f2.colorIndices.push_back(face.colorIndices[i]);
+        if (!face.uvIndices.empty()) f2.uvIndices.push_back(face.uvIndices[i]);
+    }
+
+    return { f1, f2 };
+}
+} // namespace detail
+
+//--------------------------------------------------
+// MARK: MTLLoader Parsing methods
+//--------------------------------------------------
+bool MTLLoader::loadMaterialFile(const std::string& filePath)
+{
+    detail::TraceScope trace{ "MTLLoader::loadMaterialFile" };
+    const bool result = parseMaterialFile(filePath);
+    decodeImages();
+    return result;
+}
+
+bool MTLLoader::parseMaterialFile(const std::string& filePath)
+{
+    detail::TraceScope trace{ "MTLLoader::parse" };
+    m_filePath = filePath;
+    detail::trim(m_filePath);
+
+    if (!m_filePath.ends_with(".mtl")) { return false; }
+
+    std::filesystem::path objPath = m_filePath;
+    m_workingDirectory            = objPath.parent_path().string() + "/";
+
+    std::ifstream file;
+    file.open(filePath);
+
+    if (!file.is_open()) { return false; }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        detail::trim(line);
+
+        const Identifier id = detail::mtlIdentifier(line);
+        switch (id) {
+        case Identifier::NEW_MATERIAL: {
+            if (!parseNewMaterial(line)) return false;
+            break;
+        }
+        case Identifier::AMBIENT_MAP: {
+            if (!materialExists()) return false;
+            if (!setImageMap(m_materials.back().alphaMapIndex, line, id)) { return false; }
+            break;
+        }
+        case Identifier::DIFFUSE_MAP: {
+            if (!materialExists()) return false;
+            if (!setImageMap(m_materials.back().diffuseMapIndex, line, id)) { return false; }
+            break;
+        }
+        case Identifier::SPECULAR_MAP: {
+            if (!materialExists()) return false;
+            if (!setImageMap(m_materials.back().specularMapIndex, line, id)) { return false; }
+            break;
+        }
+        case Identifier::ROUGHNESS_MAP: {
+            if (!materialExists()) return false;
+            if (!setImageMap(m_materials.back().roughnessMapIndex, line, id)) { return false; }
+            break;
+        }
+        case Identifier::ALPHA_MAP: {
+            if (!materialExists()) return false;
+            if (!setImageMap(m_materials.back().ambientMapIndex, line, id)) { return false; }
+            break;
+        }
+        case Identifier::AMBIENT: {
+            if (!materialExists()) return false;
+            const auto result = m_mathParser.parseVec3(line);
+            if (!result) {
+                m_logger->error(std::format(
+                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
+                return false;
+            }
+            m_materials.back().ambient = result;
+            break;
+        }
+        case Identifier::DIFFUSE: {
+            if (!materialExists()) return false;
+            const auto result = m_mathParser.parseVec3(line);
+            if (!result) {
+                m_logger->error(std::format(
+                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
+                return false;
+            }
+            m_materials.back().diffuse = result;
+            break;
+        }
+        case Identifier::SPECULAR: {
+            if (!materialExists()) return false;
+            const auto result = m_mathParser.parseVec3(line);
+            if (!result) {
+                m_logger->error(std::format(
+                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
+                return false;
+            }
+            m_materials.back().specular = result;
+            break;
+        }
+        case Identifier::ROUGHNESS: {
+            if (!materialExists()) return false;
+            const auto result = m_mathParser.parseFloat(line);
+            if (!result) {
+                m_logger->error(std::format(
+                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
+                return false;
+            }
+            m_materials.back().roughness = result;
+            break;
+        }
+        case Identifier::ALPHA: {
+            if (!materialExists()) return false;
+            const auto result = m_mathParser.parseFloat(line);
+            if (!result) {
+                m_logger->error(std::format(
+                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
+                return false;
+            }
+            m_materials.back().alpha = result;
+            break;
+        }
+        case Identifier::COMMENT:
+        case Identifier::BLANK:
+            break;
+        case Identifier::UNKNOWN:
+            m_logger->warn(
+                std::format("Unknown identifier encountered in {} at line {}", m_filePath, m_line));
+            break;
+        }
+
+        m_line++;
+    }
+
+    return true;
+}
+
+bool MTLLoader::parseNewMaterial(const std::string& str)
+{
+    std::stringstream stream{ str };
+    std::string _;
+    std::string name;
+
+    stream >> _ >> name;
+
+    if (stream.fail()) { return false; }
+
+    const NameID id = m_names.intern(name);
+    if (m_materialNameToIndex.contains(id)) { return false; }
+
+    m_materials.push_back({});
+    m_materials.back().name = id;
+    m_materialNameToIndex[id] = m_materials.size() - 1;
+
+    return true;
+}
+
+std::optional<uint32_t> MTLLoader::parseImage(const std::string& str)
+{
+    std::stringstream stream{ str };
+    std::string _;
+    std::string path;
+
+    stream >> _ >> path;
+
+    detail::trim(path);
+    const NameID name = m_names.intern(detail::fileNameFromPath(path));
+
+    if (m_loadedImageToIndex.contains(name)) { return m_loadedImageToIndex[name]; }
+
+    if (stream.fail()) { return std::nullopt; }
+
+    // only reserve the slot here, see decodeImages
+    ImageData data;
+    data.name = name;
+    m_images.push_back(std::move(data));
+    m_imagePaths.push_back(m_workingDirectory + path);
+    m_loadedImageToIndex[name] = m_images.size() - 1;
+
+    return m_loadedImageToIndex[name];
+}
+
+void MTLLoader::decodeImages()
+{
+    stbi_set_flip_vertically_on_load(true);
+
+    m_executor->parallelFor(m_images.size(), [this](const size_t i) {
+        ImageData& data = m_images[i];
+        if (!data.bytes.empty()) return;
+
+        detail::TraceScope trace{ "MTLLoader::parseImage" };
+        const auto begin = std::chrono::steady_clock::now();
+
+        int x, y, channels;
+        unsigned char* bytes = stbi_load(m_imagePaths[i].c_str(), &x, &y, &channels, STBI_default);
+        Metrics::instance().recordTextureDecode(std::chrono::steady_clock::now() - begin, bytes);
+        if (!bytes) {
+            m_logger->warn(std::format("Could not load image {} referenced in {}",
+                                       m_imagePaths[i],
+                                       m_filePath));
+            return;
+        }
+        const size_t size = static_cast<size_t>(x) * y * channels;
+        // the decoded pixels and their copy are alive at the same time
+        if (m_memory) m_memory->allocate(2 * size);
+
+        data.bytes    = std::vector(bytes, bytes + size);
+        data.width    = x;
+        data.height   = y;
+        data.channels = channels;
+
+        stbi_image_free(bytes);
+        if (m_memory) m_memory->release(size);
+    });
+}
+
+bool MTLLoader::setImageMap(std::optional<uint32_t>& imageMapIndex, const std::string& line,
+                            const Identifier identifier)
+{
+    const auto result = parseImage(line);
+    if (!result) return false;
+    if (m_materials.empty()) return false;
+    if (imageMapIndex) {
+        m_logger->warn(std::format("Defined two {} image maps in file {} at line {}",
+                                   toString(identifier),
+                                   m_filePath,
+                                   m_line));
+    }
+    imageMapIndex = result;
+
+    return true;
+}
+
+//--------------------------------------------------
+// MARK: OBJLoader Parsing methods
+//--------------------------------------------------
+bool OBJLoader::load(const std::string& filePath)
+{
+    detail::TraceScope trace{ "OBJLoader::load" };
+    detail::LoadRecord record{};
+    reset();
+    m_peakMemory = 0;
+    // a successful load resolves every library, any other return has to wait for them
+    const detail::ScopeExit pendingLibraries{ [this] { discardMaterialLibraries(); } };
+    if (m_reclaimer) {
+        m_reclaimer->reuse(m_positions);
+        m_reclaimer->reuse(m_normals);
+        m_reclaimer->reuse(m_textureUVs);
+        m_reclaimer->reuse(m_colors);
+    }
+    for (const size_t bytes : { detail::memoryUsage(m_positions).reserved,
+                                detail::memoryUsage(m_normals).reserved,
+                                detail::memoryUsage(m_textureUVs).reserved,
+                                detail::memoryUsage(m_colors).reserved,
+                                m_names.reservedBytes() }) {
+        m_memory->allocate(bytes);
+    }
+
+    detail::trim(m_filePath);
+    m_filePath = filePath;
+
+    std::filesystem::path objPath = m_filePath;
+    m_workingDirectory            = objPath.parent_path().string() + "/";
+
+    if (!m_filePath.ends_with(".obj")) {
+        m_logger->error(std::format("The file {} does not have the .obj extension", m_filePath));
+        return false;
+    }
+
+    // open file, TODO(Error handling here?)
+    detail::TraceScope traceOpen{ "OBJLoader::open" };
+    std::ifstream file;
     file.open(filePath);
+    traceOpen.end();
+
+    if (!file.is_open()) return false;
+
+    // lines are streamed, so this includes reading the file
+    detail::TraceScope traceParse{ "OBJLoader::parse" };
+    std::string line;
+    while (std::getline(file, line)) {
+        record.bytes += line.size() + 1;
+        detail::trim(line);
+
+        switch (detail::objIdentifier(line)) {
+        case Identifier::POSITION: {
+            const auto result = m_mathParser.parseVec3(line);
+            if (!result) {
+                m_logger->error(std::format(
+                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
+                return false;
+            }
+            detail::trackedPush(m_positions, *result, *m_memory);
+            m_config.transform.apply(m_positions.back());
+            break;
+        }
+        case Identifier::NORMAL: {
+            const auto result = m_mathParser.parseVec3(line);
+            if (!result) {
+                m_logger->error(std::format(
+                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
+                return false;
+            }
+            detail::trackedPush(m_normals, *result, *m_memory);
+            m_config.transform.applyNormal(m_normals.back());
+            break;
+        }
+        case Identifier::UV: {
+            const auto result = m_mathParser.parseVec2(line);
+            if (!result) {
+                m_logger->error(std::format(
+                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
+                return false;
+            }
+            detail::trackedPush(m_textureUVs, *result, *m_memory);
+            m_config.transform.apply(m_textureUVs.back());
+            break;
+        }
+        case Identifier::FACE: {
+            const auto result = parseFace(line);
+            if (!result) return false;
+            if (m_config.triangulate) {
+                pushFaces(detail::triangulate(*result));
+            } else {
+                pushFace(*result);
+            }
+            break;
+        }
+        case Identifier::SMOOTH_SHADING: {
+            parseSmoothShading(line);
+            break;
+        }
+        case Identifier::NAMED_OBJECT: {
+            parseNamedObject(line);
+            break;
+        }
+        case Identifier::GROUP: {
+            parseGroup(line);
+            break;
+        }
+        case Identifier::MATERIAL_LIB: {
+            const auto result = parseMaterialFilePath(line);
+            if (!result) return false;
+            loadMaterialLibrary(m_workingDirectory + *result); // look in this dir
+            break;
+        }
+        case Identifier::USE_MATERIAL: {
+            parseUseMaterial(line);
+            break;
+        }
+        case Identifier::BLANK:
+        case Identifier::COMMENT:
+            break;
+        case Identifier::UNKNOWN:
+            m_logger->warn(std::format(
+                "Encountered unknown line identifier in file {} at line {}.", m_filePath, m_line));
+            break;
+        }
+
+        m_line++;
+    }
+
+    file.close();
+    traceParse.end();
+
+    if (!m_meshes.empty()) publishMesh(m_meshes.size() - 1);
+    resolveMaterials();
+
+    if (m_positions.empty()) {
+        m_logger->error(std::format(".obj file {} must include at least 1 position", m_filePath));
+        return false;
+    }
+
+    m_logger->info(std::format("Successfully parsed and loaded data from {}", m_filePath));
+
+    shrink();
+    m_peakMemory = m_memory->peak();
+
+    for (const auto& mesh : m_meshes) {
+        record.faces += mesh.faces.size();
+    }
+    record.success = true;
+
+    return true;
+}
+
+std::optional<Vec3> MathParser::parseVec3(const std::string& str) const
+{
+    // TODO: handle too many args? what about comments inline
+    std::stringstream stream{ str };
+    float x, y, z;
+    std::string _;
+    stream >> _ >> x >> y >> z;
+    if (stream.fail()) { return std::nullopt; }
+
+    return { { x, y, z } };
+}
+
+std::optional<Vec2> MathParser::parseVec2(const std::string& str) const
+{
+    // TODO: handle too many args? what about comments inline
+    std::stringstream stream{ str };
+    float x, y;
+    std::string _;
+    stream >> _ >> x >> y;
+    if (stream.fail()) { return std::nullopt; }
+
+    return { { x, y } };
+}
+
+std::optional<float> MathParser::parseFloat(const std::string& str) const
+{
+    // TODO: handle too many args? what about comments inline
+    std::stringstream stream{ str };
+    float x;
+    std::string _;
+    stream >> _ >> x;
+    if (stream.fail()) { return std::nullopt; }
+
+    return { x };
+}
+
+std::optional<Face> OBJLoader::parseFace(const std::string& str)
+{
+    auto parsed = detail::parseFace(str,
+                                    { m_positions.size(), m_normals.size(), m_textureUVs.size() },
+                                    *m_logger,
+                                    m_filePath,
+                                    m_line);
+    if (!parsed.unified) currentMesh().unifiedIndices = false;
+    return std::move(parsed.face);
+}
+
+void OBJLoader::parseSmoothShading(const std::string& str)
+{
+    std::stringstream stream{ str };
+    std::string _;
+    std::string toggle{};
+    stream >> _ >> toggle;
+
+    // word syntax, on is treated as group 1
+    if (toggle == detail::OFF) {
+        m_smoothingGroup = 0;
+        return;
+    }
+    if (toggle == detail::ON) {
+        m_smoothingGroup = 1;
+        return;
+    }
+
+    // number syntax, 0 turns smoothing off
+    uint32_t group = 0;
+    const auto [ptr, ec] = std::from_chars(toggle.data(), toggle.data() + toggle.size(), group);
+    if (ec != std::errc{} || ptr != toggle.data() + toggle.size()) {
+        m_logger->warn(std::format(
+            "Could not parse file {} line {} due to unknown word {}", m_filePath, m_line, toggle));
+        return;
+    }
+    m_smoothingGroup = group;
+}
+
+void OBJLoader::parseGroup(const std::string& str)
+{
+    std::string_view rest{ str };
+    detail::nextToken(rest);
+
+    std::vector<NameID> groups{};
+    for (auto name = detail::nextToken(rest); !name.empty(); name = detail::nextToken(rest)) {
+        groups.push_back(intern(name));
+    }
+    // "g" on its own is valid and names the default group
+    if (groups.empty()) groups.push_back(intern(detail::DEFAULT_MESH_NAME));
+
+    const NameID name = groups.front();
+    makeGroup(name, std::move(groups));
+}
+
+void OBJLoader::parseNamedObject(const std::string& str)
+{
+    std::string_view rest{ str };
+    detail::nextToken(rest);
+    makeGroup(intern(detail::trimmed(rest)));
+}
+
+std::optional<std::string> OBJLoader::parseMaterialFilePath(const std::string& str) const
+{
+    std::stringstream stream{ str };
+    std::string _;
+    std::string path{};
+    stream >> _;
+    std::getline(stream, path);
+    detail::trim(path);
+    return { path };
+}
+
+bool OBJLoader::parseUseMaterial(const std::string& str)
+{
+    std::stringstream stream{ str };
+    std::string _;
+    std::string name;
+    stream >> _;
+    std::getline(stream, name);
+    detail::trim(name);
+
+    if (stream.fail()) { return false; }
+
+    // the material library may still be loading and the mesh may not exist yet, so only
+    // remember the name for now
+    m_currentMaterial = intern(name);
+
+    return true;
+}
+
+void OBJLoader::loadMaterialLibrary(const std::string& filePath)
+{
+    auto task = std::make_shared<detail::ClaimableTask<MaterialLibrary>>(
+        [logger = m_logger, executor = executor(), memory = m_memory, filePath] {
+            MTLLoader loader{ logger, executor };
+            loader.setMemoryTracker(memory);
+            if (!loader.loadMaterialFile(filePath)) {
+                logger->warn(std::format("Could not load material library {}", filePath));
+            }
+            return MaterialLibrary{ loader.stealMaterials(),
+                                    loader.stealImages(),
+                                    loader.stealNames() };
+        });
+    executor()->submit([task] { task->run(); });
+    m_materialLibraries.push_back(std::move(task));
+}
+
+void OBJLoader::discardMaterialLibraries()
+{
+    // make sure no library is still writing to the logger
+    for (auto& task : m_materialLibraries) {
+        try {
+            task->get();
+        } catch (...) {
+            // the load that started it failed already
+        }
+    }
+    m_materialLibraries.clear();
+}
+
+void OBJLoader::resolveMaterials()
+{
+    detail::TraceScope trace{ "OBJLoader::resolveMaterials" };
+    for (auto& task : m_materialLibraries) {
+        MaterialLibrary library = task->get();
+
+        // image indices are local to their library
+        const auto imageOffset = static_cast<uint32_t>(m_images.size());
+        for (auto& material : library.materials) {
+            for (auto* index : { &material.ambientMapIndex,
+                                 &material.diffuseMapIndex,
+                                 &material.specularMapIndex,
+                                 &material.roughnessMapIndex,
+                                 &material.alphaMapIndex }) {
+                if (*index) **index += imageOffset;
+            }
+            // names are interned per library
+            material.name = intern(library.names.view(material.name));
+            m_materialNameToIndex.try_emplace(material.name, m_materials.size());
+            m_materials.push_back(std::move(material));
+        }
+        for (auto& image : library.images) {
+            image.name = intern(library.names.view(image.name));
+            detail::trackedPush(m_images, std::move(image), *m_memory);
+        }
+    }
+    m_materialLibraries.clear();
+
+    for (const auto& [meshIndex, name] : m_pendingMaterials) {
+        const auto it = m_materialNameToIndex.find(name);
+        if (it == m_materialNameToIndex.end()) {
+            m_logger->warn(std::format(
+                "Material {} used in {} was never defined", m_names.view(name), m_filePath));
+            continue;
+        }
+        m_meshes[meshIndex].materialIndex = it->second;
+    }
+    m_pendingMaterials.clear();
+}
+
+//--------------------------------------------------
+// MARK: MTLLoader Helper Methods
+//--------------------------------------------------
+
+std::string MTLLoader::toString(const Identifier identifier) const
+{
+    switch (identifier) {
+    case Identifier::NEW_MATERIAL:
+        return "newmtl";
+    case Identifier::AMBIENT_MAP:
+        return "map_Ka";
+    case Identifier::DIFFUSE_MAP:
+        return "map_Kd";
+    case Identifier::SPECULAR_MAP:
+        return "map_Ks";
+    case Identifier::ROUGHNESS_MAP:
+        return "map_Ns";
+    case Identifier::ALPHA_MAP:
+        return "map_d";
+    case Identifier::AMBIENT:
+        return "Ka";
+    case Identifier::DIFFUSE:
+        return "Kd";
+    case Identifier::SPECULAR:
+        return "Ks";
+    case Identifier::ROUGHNESS:
+        return "Ns";
+    case Identifier::ALPHA:
+        return "d";
+    case Identifier::COMMENT:
+        return "#";
+    case Identifier::BLANK:
+        return "";
+    case Identifier::UNKNOWN:
+        return "unknown";
+    default:
+        return "invalid";
+    }
+}
+
+std::vector<Material> MTLLoader::stealMaterials()
+{
+    return std::move(m_materials);
+}
+
+std::vector<ImageData> MTLLoader::stealImages()
+{
+    return std::move(m_images);
+}
+
+NamePool MTLLoader::stealNames()
+{
+    return std::move(m_names);
+}
+
+std::unordered_map<NameID, uint32_t> MTLLoader::materialNameToIndex()
+{
+    return m_materialNameToIndex;
+}
+
+void MTLLoader::setMemoryTracker(std::shared_ptr<MemoryTracker> memory)
+{
+    m_memory = std::move(memory);
+}
+
+void MTLLoader::reset()
+{
+    m_materials.clear();
+    m_images.clear();
+    m_imagePaths.clear();
+    m_names.clear();
+    m_loadedImageToIndex.clear();
+    m_materialNameToIndex.clear();
+    m_filePath.clear();
+    m_line = 0;
+}
+
+bool MTLLoader::materialExists() const
+{
+    if (m_materials.empty()) {
+        m_logger->error(
+            std::format("Attempting to load images before declaring a material in {} at line {}",
+                        m_filePath,
+                        m_line));
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------
+// MARK: OBJLoader Helper Methods
+//--------------------------------------------------
+
+size_t OBJLoader::peakMemory() const
+{
+    return m_peakMemory;
+}
+
+OBJData OBJLoader::steal()
+{
+    OBJData data;
+    data.name       = detail::fileNameFromPath(m_filePath);
+    data.positions  = std::move(m_positions);
+    data.normals    = std::move(m_normals);
+    data.textureUVs = std::move(m_textureUVs);
+    data.colors     = std::move(m_colors);
+    data.meshes     = std::move(m_meshes);
+    data.materials  = std::move(m_materials);
+    data.images     = std::move(m_images);
+    data.names      = std::move(m_names);
+
+    reset();
+
+    return data;
+}
+
+OBJData OBJLoader::share() const
+{
+    OBJData data;
+    data.name       = detail::fileNameFromPath(m_filePath);
+    data.positions  = m_positions;
+    data.normals    = m_normals;
+    data.textureUVs = m_textureUVs;
+    data.colors     = m_colors;
+    data.meshes     = m_meshes;
+    data.materials  = m_materials;
+    data.images     = m_images;
+    data.names      = m_names;
+
+    return data;
+}
+
+void OBJLoader::reset()
+{
+    m_line            = 0;
+    m_currentMeshName = 0;
+    m_smoothingGroup  = 0;
+    m_filePath.clear();
+    m_positions.clear();
+    m_normals.clear();
+    m_textureUVs.clear();
+    m_colors.clear();
+    m_meshes.clear();
+    discardMaterialLibraries();
+    // only once no library can report to it anymore
+    m_memory->reset();
+    m_pendingMaterials.clear();
+    m_currentMaterial = std::nullopt;
+    m_materials.clear();
+    m_images.clear();
+    m_materialNameToIndex.clear();
+    m_names.clear();
+    m_logger->clear();
+}
+
+std::string OBJLoader::toString(const Identifier id) const
+{
+    switch (id) {
+    case Identifier::POSITION:
+        return "v";
+    case Identifier::NORMAL:
+        return "vn";
+    case Identifier::UV:
+        return "vt";
+    case Identifier::FACE:
+        return "f";
+    case Identifier::GROUP:
+        return "g";
+    case Identifier::NAMED_OBJECT:
+        return "o";
+    case Identifier::SMOOTH_SHADING:
+        return "s";
+    case Identifier::MATERIAL_LIB:
+        return "mtllib";
+    case Identifier::USE_MATERIAL:
+        return "usemtl";
+    case Identifier::COMMENT:
+        return "#";
+    case Identifier::BLANK:
+        return "";
+    case Identifier::UNKNOWN:
+    default:
+        return "UNKNOWN";
+    }
+}
+
+void OBJLoader::pushFace(const Face& face)
+{
+    Mesh& mesh = currentMesh();
+    bindMaterial();
+    pushSmoothingGroup(mesh);
+    detail::trackedPush(mesh.faces, face, *m_memory);
+    m_memory->allocate(detail::faceIndexBytes(mesh.faces.back()));
+}
+
+void OBJLoader::pushFaces(const std::vector<Face>& faces)
+{
+    Mesh& mesh = currentMesh();
+    bindMaterial();
+    pushSmoothingGroup(mesh);
+    for (const auto& face : faces) {
+        detail::trackedPush(mesh.faces, face, *m_memory);
+        m_memory->allocate(detail::faceIndexBytes(mesh.faces.back()));
+    }
+}
+
+void OBJLoader::shrink()
+{
+    detail::TraceScope trace{ "OBJLoader::shrink" };
+    // pooled buffers would just be copied into smaller ones
+    if (!m_reclaimer) {
+        detail::trackedShrink(m_positions, *m_memory);
+        detail::trackedShrink(m_normals, *m_memory);
+        detail::trackedShrink(m_textureUVs, *m_memory);
+        detail::trackedShrink(m_colors, *m_memory);
+    }
+    detail::trackedShrink(m_images, *m_memory);
+    m_materials.shrink_to_fit();
+    detail::trackedShrink(m_meshes, *m_memory);
+    for (auto& mesh : m_meshes) {
+        detail::trackedShrink(mesh.faces, *m_memory);
+        detail::trackedShrink(mesh.smoothingGroups, *m_memory);
+    }
+}
+
+void OBJLoader::pushSmoothingGroup(Mesh& mesh) const
+{
+    // faces start out in group 0 (smoothing off), so only changes need a new run. this is
+    // called right before faces are pushed, so runs are never empty
+    const uint32_t previous = mesh.smoothingGroups.empty() ? 0 : mesh.smoothingGroups.back().group;
+    if (previous == m_smoothingGroup) return;
+
+    const SmoothingRun run{ static_cast<uint32_t>(mesh.faces.size()), m_smoothingGroup };
+    detail::trackedPush(mesh.smoothingGroups, run, *m_memory);
+}
+
+std::shared_ptr<Executor> OBJLoader::executor() const
+{
+    return m_executor ? m_executor : defaultExecutor();
+}
+
+void OBJLoader::publishMesh(const size_t meshIndex) const
+{
+    if (!m_config.meshCallback) return;
+
+    std::optional<std::string_view> materialName = std::nullopt;
+    for (auto it = m_pendingMaterials.rbegin(); it != m_pendingMaterials.rend(); ++it) {
+        if (it->first < meshIndex) break;
+        if (it->first == meshIndex) {
+            materialName = m_names.view(it->second);
+            break;
+        }
+    }
+
+    const Mesh& mesh = m_meshes[meshIndex];
+    m_config.meshCallback(MeshView{
+        .mesh         = mesh,
+        .meshIndex    = meshIndex,
+        .name         = m_names.view(mesh.name),
+        .materialName = materialName,
+        .positions    = m_positions,
+        .normals      = m_normals,
+        .textureUVs   = m_textureUVs,
+        .colors       = m_colors,
+    });
+}
+
+NameID OBJLoader::intern(const std::string_view name)
+{
+    const size_t before = m_names.reservedBytes();
+    const NameID id     = m_names.intern(name);
+    // the pool never gives memory back before clear()
+    m_memory->allocate(m_names.reservedBytes() - before);
+    return id;
+}
+
+void OBJLoader::bindMaterial()
+{
+    if (!m_currentMaterial) return;
+    m_pendingMaterials.emplace_back(m_meshes.size() - 1, *m_currentMaterial);
+    m_currentMaterial = std::nullopt;
+}
+
+Mesh& OBJLoader::currentMesh()
+{
+    // faces may appear before any g or o line
+    if (m_meshes.empty()) {
+        detail::trackedPush(m_meshes, Mesh{}, *m_memory);
+        m_meshes.back().name = intern(detail::DEFAULT_MESH_NAME);
+    }
+    return m_meshes.back();
+}
+
+void OBJLoader::makeGroup(const NameID name, std::vector<NameID> groups)
+{
+    m_currentMeshName = name;
+
+    // the previous group can not receive any more faces
+    if (!m_meshes.empty()) publishMesh(m_meshes.size() - 1);
+
+    // always make a new group
+    detail::trackedPush(m_meshes, Mesh{}, *m_memory);
+    m_meshes.back().name   = name;
+    m_meshes.back().groups = std::move(groups);
+}
+
+//--------------------------------------------------
+// MARK: Transforms
+//--------------------------------------------------
+
+Mat4 Mat4::scale(const float factor)
+{
+    Mat4 result{};
+    result.values[0]  = factor;
+    result.values[5]  = factor;
+    result.values[10] = factor;
+    return result;
+}
+
+Mat4 Mat4::zUpToYUp()
+{
+    Mat4 result{};
+    result.values = { 1, 0, 0, 0, 0, 0, -1, 0, 0, 1, 0, 0, 0, 0, 0, 1 };
+    return result;
+}
+
+Mat4 Mat4::operator*(const Mat4& other) const
+{
+    Mat4 result{};
+    for (size_t column = 0; column < 4; column++) {
+        for (size_t row = 0; row < 4; row++) {
+            float sum = 0.0f;
+            for (size_t i = 0; i < 4; i++) {
+                sum += values[i * 4 + row] * other.values[column * 4 + i];
+            }
+            result.values[column * 4 + row] = sum;
+        }
+    }
+    return result;
+}
+
+Vec3 Mat4::transformPoint(const Vec3& point) const
+{
+#ifdef SOBJ_SSE2
+    // one column per register, the result is the weighted sum of the columns
+    const __m128 x      = _mm_mul_ps(_mm_loadu_ps(&values[0]), _mm_set1_ps(point.x));
+    const __m128 y      = _mm_mul_ps(_mm_loadu_ps(&values[4]), _mm_set1_ps(point.y));
+    const __m128 z      = _mm_mul_ps(_mm_loadu_ps(&values[8]), _mm_set1_ps(point.z));
+    const __m128 result = _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, _mm_loadu_ps(&values[12])));
+    alignas(16) float out[4];
+    _mm_store_ps(out, result);
+    return { out[0], out[1], out[2] };
+#else
+    const Vec3 result = transformDirection(point);
+    return { result.x + values[12], result.y + values[13], result.z + values[14] };
+#endif
+}
+
+Vec3 Mat4::transformDirection(const Vec3& direction) const
+{
+    return {
+        values[0] * direction.x + values[4] * direction.y + values[8] * direction.z,
+        values[1] * direction.x + values[5] * direction.y + values[9] * direction.z,
+        values[2] * direction.x + values[6] * direction.y + values[10] * direction.z,
+    };
+}
+
+Mat4 Mat4::normalMatrix() const
+{
+    const auto at = [this](const size_t row, const size_t column) {
+        return values[column * 4 + row];
+    };
+
+    // the inverse transpose is the cofactor matrix divided by the determinant
+    Mat4 result{};
+    for (size_t row = 0; row < 3; row++) {
+        for (size_t column = 0; column < 3; column++) {
+            const size_t r0 = (row + 1) % 3;
+            const size_t r1 = (row + 2) % 3;
+            const size_t c0 = (column + 1) % 3;
+            const size_t c1 = (column + 2) % 3;
+            result.values[column * 4 + row] = at(r0, c0) * at(r1, c1) - at(r0, c1) * at(r1, c0);
+        }
+    }
+
+    const float determinant = at(0, 0) * result.values[0] + at(0, 1) * result.values[4] +
+                              at(0, 2) * result.values[8];
+    if (determinant == 0.0f) return result;
+    for (size_t column = 0; column < 3; column++) {
+        for (size_t row = 0; row < 3; row++) {
+            result.values[column * 4 + row] /= determinant;
+        }
+    }
+    return result;
+}
+
+namespace detail
+{
+void VertexTransform::set(const Mat4& transform)
+{
+    matrix       = transform;
+    normalMatrix = transform.normalMatrix();
+}
+
+void VertexTransform::apply(Vec3& position) const
+{
+    if (matrix) position = matrix->transformPoint(position);
+}
+
+void VertexTransform::applyNormal(Vec3& normal) const
+{
+    if (!normalMatrix) return;
+    normal             = normalMatrix->transformDirection(normal);
+    const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+    if (length > 0.0f) normal = { normal.x / length, normal.y / length, normal.z / length };
+}
+
+void VertexTransform::apply(Vec2& uv) const
+{
+    if (flipUVs) uv.y = 1.0f - uv.y;
+}
+} // namespace detail
+
+//--------------------------------------------------
+// MARK: Metrics
+//--------------------------------------------------
+
+size_t Histogram::bucketIndex(const uint64_t value)
+{
+    if (value < SUB_BUCKETS) return value;
+    const size_t shift = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+    const size_t sub   = (value >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t Histogram::bucketUpperBound(const size_t index)
+{
+    if (index < SUB_BUCKETS) return index;
+    const size_t shift   = index / SUB_BUCKETS - 1;
+    const uint64_t lower = uint64_t{ SUB_BUCKETS + index % SUB_BUCKETS } << shift;
+    return lower + ((uint64_t{ 1 } << shift) - 1);
+}
+
+void Histogram::record(const uint64_t value)
+{
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+uint64_t Histogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::sum() const
+{
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::percentile(const double percentile) const
+{
+    // buckets may change while we read them, so count what we actually see
+    std::array<uint64_t, NUM_BUCKETS> buckets{};
+    uint64_t total = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+        buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += buckets[i];
+    }
+    if (total == 0) return 0;
+
+    const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+    const auto target     = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * total)));
+    uint64_t seen         = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= target) return std::min(bucketUpperBound(i), max());
+    }
+    return max();
+}
+
+void Histogram::reset()
+{
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+Metrics& Metrics::instance()
+{
+    static Metrics metrics{};
+    return metrics;
+}
+
+void Metrics::recordLoad(const std::chrono::steady_clock::duration duration, const uint64_t bytes,
+                         const uint64_t faces, const bool success)
+{
+    m_loads.fetch_add(1, std::memory_order_relaxed);
+    if (!success) {
+        m_failedLoads.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const auto micros    = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    const double seconds = std::chrono::duration<double>(duration).count();
+    m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    m_faces.fetch_add(faces, std::memory_order_relaxed);
+    m_loadMicroseconds.record(static_cast<uint64_t>(micros));
+    if (seconds > 0.0) {
+        m_bytesPerSecond.record(static_cast<uint64_t>(bytes / seconds));
+        m_facesPerSecond.record(static_cast<uint64_t>(faces / seconds));
+    }
+}
+
+void Metrics::recordTextureDecode(const std::chrono::steady_clock::duration duration,
+                                  const bool success)
+{
+    m_textures.fetch_add(1, std::memory_order_relaxed);
+    if (!success) m_failedTextures.fetch_add(1, std::memory_order_relaxed);
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    m_textureDecodeMicroseconds.record(static_cast<uint64_t>(micros));
+}
+
+MetricsSnapshot Metrics::snapshot() const
+{
+    const auto summarize = [](const Histogram& histogram) {
+        return HistogramSnapshot{
+            .count = histogram.count(),
+            .sum   = histogram.sum(),
+            .max   = histogram.max(),
+            .p50   = histogram.percentile(50.0),
+            .p95   = histogram.percentile(95.0),
+            .p99   = histogram.percentile(99.0),
+        };
+    };
+
+    return MetricsSnapshot{
+        .loads                     = m_loads.load(std::memory_order_relaxed),
+        .failedLoads               = m_failedLoads.load(std::memory_order_relaxed),
+        .bytes                     = m_bytes.load(std::memory_order_relaxed),
+        .faces                     = m_faces.load(std::memory_order_relaxed),
+        .textures                  = m_textures.load(std::memory_order_relaxed),
+        .failedTextures            = m_failedTextures.load(std::memory_order_relaxed),
+        .loadMicroseconds          = summarize(m_loadMicroseconds),
+        .bytesPerSecond            = summarize(m_bytesPerSecond),
+        .facesPerSecond            = summarize(m_facesPerSecond),
+        .textureDecodeMicroseconds = summarize(m_textureDecodeMicroseconds),
+    };
+}
+
+bool Metrics::writeOpenMetrics(const std::string& filePath) const
+{
+    std::ofstream file{ filePath };
+    if (!file.is_open()) return false;
+
+    const MetricsSnapshot metrics = snapshot();
+
+    const auto counter = [&](const std::string_view name, const uint64_t value) {
+        file << std::format("# TYPE {} counter\n{}_total {}\n", name, name, value);
+    };
+    // histograms are exported as summaries, scale converts to the base unit
+    const auto summary = [&](const std::string_view name, const HistogramSnapshot& histogram,
+                             const double scale) {
+        file << std::format("# TYPE {} summary\n", name);
+        file << std::format("{}{{quantile=\"0.5\"}} {}\n", name, histogram.p50 * scale);
+        file << std::format("{}{{quantile=\"0.95\"}} {}\n", name, histogram.p95 * scale);
+        file << std::format("{}{{quantile=\"0.99\"}} {}\n", name, histogram.p99 * scale);
+        file << std::format("{}_sum {}\n", name, histogram.sum * scale);
+        file << std::format("{}_count {}\n", name, histogram.count);
+    };
+
+    counter("sobj_loads", metrics.loads);
+    counter("sobj_load_errors", metrics.failedLoads);
+    counter("sobj_bytes", metrics.bytes);
+    counter("sobj_faces", metrics.faces);
+    counter("sobj_textures", metrics.textures);
+    counter("sobj_texture_errors", metrics.failedTextures);
+    summary("sobj_load_duration_seconds", metrics.loadMicroseconds, 1e-6);
+    summary("sobj_load_bytes_per_second", metrics.bytesPerSecond, 1.0);
+    summary("sobj_load_faces_per_second", metrics.facesPerSecond, 1.0);
+    summary("sobj_texture_decode_duration_seconds", metrics.textureDecodeMicroseconds, 1e-6);
+    file << "# EOF\n";
+
+    return static_cast<bool>(file);
+}
+
+void Metrics::reset()
+{
+    m_loads.store(0, std::memory_order_relaxed);
+    m_failedLoads.store(0, std::memory_order_relaxed);
+    m_bytes.store(0, std::memory_order_relaxed);
+    m_faces.store(0, std::memory_order_relaxed);
+    m_textures.store(0, std::memory_order_relaxed);
+    m_failedTextures.store(0, std::memory_order_relaxed);
+    m_loadMicroseconds.reset();
+    m_bytesPerSecond.reset();
+    m_facesPerSecond.reset();
+    m_textureDecodeMicroseconds.reset();
+}
+
+namespace detail
+{
+LoadRecord::~LoadRecord()
+{
+    Metrics::instance().recordLoad(std::chrono::steady_clock::now() - begin, bytes, faces, success);
+}
+} // namespace detail
+
+//--------------------------------------------------
+// MARK: Tracing
+//--------------------------------------------------
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer{};
+    return tracer;
+}
+
+void Tracer::enable()
+{
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable()
+{
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+bool Tracer::enabled() const
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+Tracer::ThreadBuffer& Tracer::threadBuffer()
+{
+    // hands the buffer back when the thread exits, so pools that come and go reuse buffers
+    struct Registration {
+        ThreadBuffer* buffer = nullptr;
+
+        ~Registration()
+        {
+            if (buffer) Tracer::instance().release(*buffer);
+        }
+    };
+    thread_local Registration registration{};
+    if (registration.buffer) return *registration.buffer;
+
+    std::lock_guard lock{ m_mutex };
+    if (!m_free.empty()) {
+        registration.buffer = m_free.back();
+        m_free.pop_back();
+        return *registration.buffer;
+    }
+    m_buffers.push_back(std::make_unique<ThreadBuffer>());
+    registration.buffer           = m_buffers.back().get();
+    registration.buffer->threadID = static_cast<uint32_t>(m_buffers.size());
+    return *registration.buffer;
+}
+
+void Tracer::release(ThreadBuffer& buffer)
+{
+    std::lock_guard lock{ m_mutex };
+    m_free.push_back(&buffer);
+}
+
+uint64_t Tracer::ThreadBuffer::firstEvent(const uint64_t written) const
+{
+    return std::max(written > CAPACITY ? written - CAPACITY : 0, cleared);
+}
+
+void Tracer::record(const char* name, const std::chrono::steady_clock::time_point begin,
+                    const std::chrono::steady_clock::time_point end)
+{
+    // single writer per buffer, old events are overwritten once it is full
+    ThreadBuffer& buffer = threadBuffer();
+    const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    buffer.events[index % CAPACITY] = { name, begin, end };
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::writeChromeTrace(const std::string& filePath) const
+{
+    std::ofstream file{ filePath };
+    if (!file.is_open()) return false;
+
+    const auto micros = [this](const std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration<double, std::micro>(time - m_epoch).count();
+    };
+
+    std::lock_guard lock{ m_mutex };
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : m_buffers) {
+        file << (first ? "" : ",")
+             << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                            "\"args\":{{\"name\":\"sobj {}\"}}}}",
+                            buffer->threadID,
+                            buffer->threadID);
+        first = false;
+
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        for (uint64_t i = buffer->firstEvent(written); i < written; i++) {
+            const Event& event = buffer->events[i % CAPACITY];
+            file << std::format(",{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},"
+                                "\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                                event.name,
+                                buffer->threadID,
+                                micros(event.begin),
+                                micros(event.end) - micros(event.begin));
+        }
+    }
+    file << "]}\n";
+
+    return static_cast<bool>(file);
+}
+
+std::vector<std::pair<std::string_view, std::chrono::steady_clock::duration>> Tracer::totals() const
+{
+    std::vector<std::pair<std::string_view, std::chrono::steady_clock::duration>> totals{};
+    std::lock_guard lock{ m_mutex };
+    for (const auto& buffer : m_buffers) {
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        for (uint64_t i = buffer->firstEvent(written); i < written; i++) {
+            const Event& event = buffer->events[i % CAPACITY];
+            const auto it      = std::ranges::find(totals, std::string_view{ event.name },
+                                                   &decltype(totals)::value_type::first);
+            if (it == totals.end()) {
+                totals.emplace_back(event.name, event.end - event.begin);
+            } else {
+                it->second += event.end - event.begin;
+            }
+        }
+    }
+    std::ranges::sort(totals, {}, &decltype(totals)::value_type::first);
+    return totals;
+}
+
+void Tracer::clear()
+{
+    std::lock_guard lock{ m_mutex };
+    for (auto& buffer : m_buffers) {
+        buffer->cleared = buffer->written.load(std::memory_order_acquire);
+    }
+}
+
+namespace detail
+{
+TraceScope::TraceScope(const char* name)
+{
+    if (!Tracer::instance().enabled()) return;
+    m_name  = name;
+    m_begin = std::chrono::steady_clock::now();
+}
+
+TraceScope::~TraceScope()
+{
+    end();
+}
+
+void TraceScope::end()
+{
+    if (!m_name) return;
+    Tracer::instance().record(m_name, m_begin, std::chrono::steady_clock::now());
+    m_name = nullptr;
+}
+} // namespace detail
+
+//--------------------------------------------------
+// MARK: Executor
+//--------------------------------------------------
+
+void Executor::parallelFor(const size_t count, const std::function<void(size_t)>& fn)
+{
+    if (count == 0) return;
+    if (count == 1) {
+        fn(0);
+        return;
+    }
+
+    // indices are handed out in blocks. helpers that only start once everything is claimed
+    // exit right away, so the state is shared with them
+    struct State {
+        const std::function<void(size_t)>* fn = nullptr;
+        size_t count                          = 0;
+        size_t grain                          = 1;
+        std::atomic<size_t> next              = 0;
+        std::atomic<size_t> done              = 0;
+        std::mutex mutex{};
+        std::condition_variable finished{};
+        std::exception_ptr error = nullptr;
+    };
+
+    const size_t numHelpers = std::min<size_t>(count - 1, std::max<size_t>(1, concurrency()) - 1);
+    auto state   = std::make_shared<State>();
+    state->fn    = &fn;
+    state->count = count;
+    state->grain = std::max<size_t>(1, count / ((numHelpers + 1) * 8));
+
+    const auto drain = [state] {
+        for (;;) {
+            const size_t begin = state->next.fetch_add(state->grain);
+            if (begin >= state->count) return;
+            const size_t end = std::min(begin + state->grain, state->count);
+            detail::TraceScope trace{ "Executor::parallelFor" };
+            for (size_t i = begin; i < end; i++) {
+                try {
+                    (*state->fn)(i);
+                } catch (...) {
+                    std::lock_guard lock{ state->mutex };
+                    if (!state->error) state->error = std::current_exception();
+                }
+            }
+            if (state->done.fetch_add(end - begin) + (end - begin) == state->count) {
+                std::lock_guard lock{ state->mutex };
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    for (size_t i = 0; i < numHelpers; i++) {
+        submit(drain);
+    }
+    drain();
+
+    std::unique_lock lock{ state->mutex };
+    state->finished.wait(lock, [&] { return state->done == state->count; });
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+size_t Executor::concurrency() const
+{
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(const size_t numThreads)
+{
+    for (size_t i = 0; i < std::max<size_t>(1, numThreads); i++) {
+        m_threads.emplace_back([this] { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskAvailable.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock lock{ m_mutex };
+    m_idle.wait(lock, [this] { return m_tasks.empty() && m_running == 0; });
+}
+
+size_t ThreadPool::concurrency() const
+{
+    return m_threads.size() + 1;
+}
+
+size_t ThreadPool::numThreads() const
+{
+    return m_threads.size();
+}
+
+void ThreadPool::work()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock{ m_mutex };
+            m_taskAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            m_running++;
+        }
+
+        task();
+
+        {
+            std::lock_guard lock{ m_mutex };
+            m_running--;
+            if (m_tasks.empty() && m_running == 0) m_idle.notify_all();
+        }
+    }
+}
+
+std::shared_ptr<Executor> defaultExecutor()
+{
+    static const auto pool = std::make_shared<ThreadPool>();
+    return pool;
+}
+
+//--------------------------------------------------
+// MARK: Reclaimer
+//--------------------------------------------------
+
+Reclaimer::Reclaimer(const size_t maxPooledBytes, std::shared_ptr<Executor> executor)
+    : m_executor(executor ? std::move(executor) : defaultExecutor()),
+      m_maxPooledBytes(maxPooledBytes)
+{
+}
+
+Reclaimer::~Reclaimer()
+{
+    // the task refers to this reclaimer, so it has to be done before anything is freed
+    std::unique_lock lock{ m_mutex };
+    drain(lock);
+    m_idle.wait(lock, [this] { return m_reclaiming == 0 && !m_scheduled; });
+}
+
+void Reclaimer::reclaim(OBJData&& data)
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        m_queue.push_back(std::move(data));
+        // the queued task takes everything reclaimed until it finishes
+        if (m_scheduled) return;
+        m_scheduled = true;
+    }
+    m_executor->submit([this] { work(); });
+}
+
+void Reclaimer::wait()
+{
+    std::unique_lock lock{ m_mutex };
+    drain(lock);
+    m_idle.wait(lock, [this] { return m_queue.empty() && m_reclaiming == 0; });
+}
+
+void Reclaimer::reuse(std::vector<Vec3>& buffer)
+{
+    take(m_vec3Pool, buffer);
+}
+
+void Reclaimer::reuse(std::vector<Vec2>& buffer)
+{
+    take(m_vec2Pool, buffer);
+}
+
+size_t Reclaimer::pooledBytes() const
+{
+    std::lock_guard lock{ m_mutex };
+    return m_pooledBytes;
+}
+
+void Reclaimer::work()
+{
+    std::unique_lock lock{ m_mutex };
+    drain(lock);
+    m_scheduled = false;
+    m_idle.notify_all();
+}
+
+void Reclaimer::drain(std::unique_lock<std::mutex>& lock)
+{
+    while (!m_queue.empty()) {
+        OBJData data = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_reclaiming++;
+        lock.unlock();
+
+        {
+            detail::TraceScope trace{ "Reclaimer::reclaim" };
+            keep(m_vec3Pool, std::move(data.positions));
+            keep(m_vec3Pool, std::move(data.normals));
+            keep(m_vec3Pool, std::move(data.colors));
+            keep(m_vec2Pool, std::move(data.textureUVs));
+            data = {};
+        }
+
+        lock.lock();
+        m_reclaiming--;
+        if (m_queue.empty() && m_reclaiming == 0) m_idle.notify_all();
+    }
+}
+
+template <typename T>
+void Reclaimer::keep(std::vector<std::vector<T>>& pool, std::vector<T>&& buffer)
+{
+    const size_t bytes = buffer.capacity() * sizeof(T);
+    if (bytes < detail::MIN_POOLED_BUFFER_SIZE) return;
+
+    // anything that does not fit is freed along with the rest of the data
+    std::lock_guard lock{ m_mutex };
+    if (m_pooledBytes + bytes > m_maxPooledBytes) return;
+    buffer.clear();
+    pool.push_back(std::move(buffer));
+    m_pooledBytes += bytes;
+}
+
+template <typename T>
+void Reclaimer::take(std::vector<std::vector<T>>& pool, std::vector<T>& buffer)
+{
+    if (buffer.capacity() != 0) return;
+
+    std::lock_guard lock{ m_mutex };
+    const auto largest = std::ranges::max_element(pool, {}, &std::vector<T>::capacity);
+    if (largest == pool.end()) return;
+    m_pooledBytes -= largest->capacity() * sizeof(T);
+    buffer = std::move(*largest);
+    pool.erase(largest);
+}
+
+//--------------------------------------------------
+// MARK: NamePool
+//--------------------------------------------------
+
+NamePool::NamePool(const NamePool& other)
+{
+    for (const auto name : other.m_names) {
+        intern(name);
+    }
+}
+
+NamePool& NamePool::operator=(const NamePool& other)
+{
+    if (this == &other) return *this;
+    clear();
+    for (const auto name : other.m_names) {
+        intern(name);
+    }
+    return *this;
+}
+
+NamePool::NamePool(NamePool&& other) noexcept
+    : m_blocks(std::move(other.m_blocks)),
+      m_blockCursor(std::exchange(other.m_blockCursor, nullptr)),
+      m_blockRemaining(std::exchange(other.m_blockRemaining, 0)),
+      m_blockBytes(std::exchange(other.m_blockBytes, 0)),
+      m_names(std::move(other.m_names)),
+      m_nameToID(std::move(other.m_nameToID))
+{
+    // the source must not keep filling a block that now belongs to this pool
+    other.clear();
+}
+
+NamePool& NamePool::operator=(NamePool&& other) noexcept
+{
+    if (this == &other) return *this;
+    m_blocks         = std::move(other.m_blocks);
+    m_blockCursor    = std::exchange(other.m_blockCursor, nullptr);
+    m_blockRemaining = std::exchange(other.m_blockRemaining, 0);
+    m_blockBytes     = std::exchange(other.m_blockBytes, 0);
+    m_names          = std::move(other.m_names);
+    m_nameToID       = std::move(other.m_nameToID);
+    other.clear();
+    return *this;
+}
+
+NameID NamePool::intern(const std::string_view name)
+{
+    if (const auto it = m_nameToID.find(name); it != m_nameToID.end()) return it->second;
+
+    char* storage = nullptr;
+    if (name.size() > BLOCK_SIZE) {
+        // oversized names get their own block so the current one keeps being filled
+        m_blocks.push_back(std::make_unique_for_overwrite<char[]>(name.size()));
+        storage = m_blocks.back().get();
+        m_blockBytes += name.size();
+    } else {
+        if (name.size() > m_blockRemaining) {
+            m_blocks.push_back(std::make_unique_for_overwrite<char[]>(BLOCK_SIZE));
+            m_blockCursor    = m_blocks.back().get();
+            m_blockRemaining = BLOCK_SIZE;
+            m_blockBytes += BLOCK_SIZE;
+        }
+        storage = m_blockCursor;
+        m_blockCursor += name.size();
+        m_blockRemaining -= name.size();
+    }
+    std::ranges::copy(name, storage);
+
+    const auto id = static_cast<NameID>(m_names.size());
+    m_names.emplace_back(storage, name.size());
+    m_nameToID.emplace(m_names.back(), id);
+    return id;
+}
+
+std::optional<NameID> NamePool::find(const std::string_view name) const
+{
+    if (const auto it = m_nameToID.find(name); it != m_nameToID.end()) return it->second;
+    return std::nullopt;
+}
+
+std::string_view NamePool::view(const NameID id) const
+{
+    assert(id < m_names.size());
+    return m_names[id];
+}
+
+size_t NamePool::size() const
+{
+    return m_names.size();
+}
+
+void NamePool::clear()
+{
+    m_blocks.clear();
+    m_blockCursor    = nullptr;
+    m_blockRemaining = 0;
+    m_blockBytes     = 0;
+    m_names.clear();
+    m_nameToID.clear();
+}
+
+MemoryUsage NamePool::memoryUsage() const
+{
+    MemoryUsage usage{ 0, m_blockBytes };
+    for (const auto name : m_names) {
+        usage.used += name.size();
+    }
+    usage += detail::memoryUsage(m_blocks);
+    usage += detail::memoryUsage(m_names);
+    usage += detail::memoryUsage(m_nameToID);
+    return usage;
+}
+
+size_t NamePool::reservedBytes() const
+{
+    return m_blockBytes + detail::memoryUsage(m_blocks).reserved +
+           detail::memoryUsage(m_names).reserved + detail::memoryUsage(m_nameToID).reserved;
+}
+
+//--------------------------------------------------
+// MARK: Vertex Buffers
+//--------------------------------------------------
+
+namespace detail
+{
+struct VertexKey {
+    uint32_t position;
+    uint32_t uv;
+    uint32_t normal;
+
+    bool operator==(const VertexKey&) const = default;
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const
+    {
+        size_t hash = key.position;
+        hash        = hash * 0x9E3779B97F4A7C15ull ^ key.uv;
+        hash        = hash * 0x9E3779B97F4A7C15ull ^ key.normal;
+        return hash;
+    }
+};
+} // namespace detail
+
+VertexBuffer buildVertexBuffer(const OBJData& data, const Mesh& mesh)
+{
+    VertexBuffer buffer;
+    if (mesh.faces.empty()) return buffer;
+
+    if (mesh.unifiedIndices) {
+        // every attribute shares the position index, so a dense table over the used range
+        // replaces hashing. vertices no face references are left out
+        constexpr uint8_t USED   = 1;
+        constexpr uint8_t NORMAL = 2;
+        constexpr uint8_t UV     = 4;
+
+        uint32_t min = UINT32_MAX;
+        uint32_t max = 0;
+        for (const auto& face : mesh.faces) {
+            for (const uint32_t index : face.positionIndices) {
+                min = std::min(min, index);
+                max = std::max(max, index);
+            }
+        }
+        if (min > max) return buffer;
+
+        // only attributes the faces carry indices for end up in the vertex, like when welding
+        std::vector<uint8_t> flags(max - min + 1, 0);
+        for (const auto& face : mesh.faces) {
+            const uint8_t faceFlags = USED | (face.normalIndices.empty() ? 0 : NORMAL) |
+                                      (face.uvIndices.empty() ? 0 : UV);
+            for (const uint32_t index : face.positionIndices) {
+                flags[index - min] |= faceFlags;
+            }
+        }
+
+        std::vector<uint32_t> remap(flags.size(), detail::NO_INDEX);
+        for (uint32_t i = min; i <= max; i++) {
+            const uint8_t vertexFlags = flags[i - min];
+            if (!(vertexFlags & USED)) continue;
+            remap[i - min] = static_cast<uint32_t>(buffer.vertices.size());
+
+            Vertex& vertex = buffer.vertices.emplace_back();
+            if (i < data.positions.size()) vertex.position = data.positions[i];
+            if (vertexFlags & NORMAL && i < data.normals.size()) vertex.normal = data.normals[i];
+            if (vertexFlags & UV && i < data.textureUVs.size()) vertex.uv = data.textureUVs[i];
+        }
+
+        for (const auto& face : mesh.faces) {
+            const auto& p = face.positionIndices;
+            for (size_t i = 1; i + 1 < p.size(); i++) {
+                buffer.indices.push_back(remap[p[0] - min]);
+                buffer.indices.push_back(remap[p[i] - min]);
+                buffer.indices.push_back(remap[p[i + 1] - min]);
+            }
+        }
+        return buffer;
+    }
+
+    std::unordered_map<detail::VertexKey, uint32_t, detail::VertexKeyHash> keyToIndex{};
+    std::vector<uint32_t> faceVertices{};
+    for (const auto& face : mesh.faces) {
+        faceVertices.clear();
+        for (size_t i = 0; i < face.numVertices(); i++) {
+            const detail::VertexKey key{
+                face.positionIndices[i],
+                face.uvIndices.empty() ? detail::NO_INDEX : face.uvIndices[i],
+                face.normalIndices.empty() ? detail::NO_INDEX : face.normalIndices[i],
+            };
+
+            const auto [it, inserted] =
+                keyToIndex.try_emplace(key, static_cast<uint32_t>(buffer.vertices.size()));
+            if (inserted) {
+                Vertex vertex{};
+                vertex.position = data.positions[key.position];
+                if (key.uv != detail::NO_INDEX) vertex.uv = data.textureUVs[key.uv];
+                if (key.normal != detail::NO_INDEX) vertex.normal = data.normals[key.normal];
+                buffer.vertices.push_back(vertex);
+            }
+            faceVertices.push_back(it->second);
+        }
+
+        for (size_t i = 1; i + 1 < faceVertices.size(); i++) {
+            buffer.indices.push_back(faceVertices[0]);
+            buffer.indices.push_back(faceVertices[i]);
+            buffer.indices.push_back(faceVertices[i + 1]);
+        }
+    }
+
+    return buffer;
+}
+
+std::vector<VertexBuffer> buildVertexBuffers(const OBJData& data,
+                                             const std::shared_ptr<Executor>& executor)
+{
+    std::vector<VertexBuffer> buffers(data.meshes.size());
+    (executor ? executor : defaultExecutor())->parallelFor(data.meshes.size(), [&](const size_t i) {
+        buffers[i] = buildVertexBuffer(data, data.meshes[i]);
+    });
+    return buffers;
+}
+
+//--------------------------------------------------
+// MARK: Local Meshes
+//--------------------------------------------------
+
+namespace detail
+{
+/// @brief Rewrites one index array of every face to point into pool, which receives the
+/// used elements of source in order of first use. Returns the source index of every element.
+template <typename T>
+std::vector<uint32_t> compactIndices(std::vector<Face>& faces,
+                                     std::vector<uint32_t> Face::*indices,
+                                     const std::vector<T>& source, std::vector<T>& pool)
+{
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    for (const auto& face : faces) {
+        for (const uint32_t index : face.*indices) {
+            min = std::min(min, index);
+            max = std::max(max, index);
+        }
+    }
+    if (min > max) return {};
+
+    // meshes mostly use a contiguous range, so a dense table over it beats hashing
+    std::vector<uint32_t> remap(max - min + 1, NO_INDEX);
+    std::vector<uint32_t> sources{};
+    for (auto& face : faces) {
+        for (uint32_t& index : face.*indices) {
+            uint32_t& local = remap[index - min];
+            if (local == NO_INDEX) {
+                local = static_cast<uint32_t>(pool.size());
+                pool.push_back(index < source.size() ? source[index] : T{});
+                sources.push_back(index);
+            }
+            index = local;
+        }
+    }
+    return sources;
+}
+
+/// @brief Gathers the elements of source for indices that have already been compacted.
+template <typename T>
+void gather(const std::vector<T>& source, const std::vector<uint32_t>& sources,
+            std::vector<T>& pool)
+{
+    pool.reserve(sources.size());
+    for (const uint32_t index : sources) {
+        pool.push_back(index < source.size() ? source[index] : T{});
+    }
+}
+} // namespace detail
+
+LocalMesh buildLocalMesh(const OBJData& data, const Mesh& mesh)
+{
+    LocalMesh local{};
+    local.mesh  = mesh;
+    auto& faces = local.mesh.faces;
+    local.positionSources =
+        detail::compactIndices(faces, &Face::positionIndices, data.positions, local.positions);
+    local.positions.shrink_to_fit();
+
+    if (mesh.unifiedIndices) {
+        // normals and uvs share the position index, so they also share its compaction
+        const auto hasNormals = [](const Face& face) { return !face.normalIndices.empty(); };
+        const auto hasUVs     = [](const Face& face) { return !face.uvIndices.empty(); };
+        if (std::ranges::any_of(faces, hasNormals)) {
+            detail::gather(data.normals, local.positionSources, local.normals);
+        }
+        if (std::ranges::any_of(faces, hasUVs)) {
+            detail::gather(data.textureUVs, local.positionSources, local.textureUVs);
+        }
+        for (auto& face : faces) {
+            if (!face.normalIndices.empty()) face.normalIndices = face.positionIndices;
+            if (!face.uvIndices.empty()) face.uvIndices = face.positionIndices;
+        }
+    } else {
+        detail::compactIndices(faces, &Face::normalIndices, data.normals, local.normals);
+        detail::compactIndices(faces, &Face::uvIndices, data.textureUVs, local.textureUVs);
+        local.normals.shrink_to_fit();
+        local.textureUVs.shrink_to_fit();
+    }
+
+    detail::compactIndices(faces, &Face::colorIndices, data.colors, local.colors);
+    local.colors.shrink_to_fit();
+    return local;
+}
+
+std::vector<LocalMesh> buildLocalMeshes(const OBJData& data,
+                                        const std::shared_ptr<Executor>& executor)
+{
+    detail::TraceScope trace{ "buildLocalMeshes" };
+    std::vector<LocalMesh> meshes(data.meshes.size());
+    (executor ? executor : defaultExecutor())->parallelFor(data.meshes.size(), [&](const size_t i) {
+        meshes[i] = buildLocalMesh(data, data.meshes[i]);
+    });
+    return meshes;
+}
+
+//--------------------------------------------------
+// MARK: Triangle View
+//--------------------------------------------------
+
+std::vector<TriangleView> TriangleView::split(const size_t parts) const
+{
+    const size_t faces = m_lastFace - m_firstFace;
+    const size_t count = std::clamp<size_t>(parts, 1, std::max<size_t>(faces, 1));
+
+    std::vector<TriangleView> views{};
+    views.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        // spread the remainder over the first views
+        const size_t begin = m_firstFace + faces * i / count;
+        const size_t end   = m_firstFace + faces * (i + 1) / count;
+        views.emplace_back(*m_mesh, begin, end);
+    }
+    return views;
+}
+
+//--------------------------------------------------
+// MARK: KDTree
+//--------------------------------------------------
+
+KDTree::KDTree(const std::span<const Vec3> points, const std::shared_ptr<Executor>& executor)
+{
+    detail::TraceScope trace{ "KDTree::build" };
+    assert(points.size() < detail::NO_INDEX);
+
+    // the tree is built as a permutation of indices, the points are gathered once at the end
+    m_indices.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        m_indices[i] = static_cast<uint32_t>(i);
+    }
+    m_axes.resize(points.size());
+    build(points, 0, points.size(), *(executor ? executor : defaultExecutor()));
+
+    m_x.resize(points.size());
+    m_y.resize(points.size());
+    m_z.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        const Vec3& point = points[m_indices[i]];
+        m_x[i]            = point.x;
+        m_y[i]            = point.y;
+        m_z[i]            = point.z;
+    }
+}
+
+void KDTree::build(const std::span<const Vec3> points, const size_t begin, const size_t end,
+                   Executor& executor)
+{
+    if (end - begin <= LEAF_SIZE) return;
+
+    Vec3 min = points[m_indices[begin]];
+    Vec3 max = min;
+    for (size_t i = begin + 1; i < end; i++) {
+        const Vec3& point = points[m_indices[i]];
+        min = { std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) };
+        max = { std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) };
+    }
+    const Vec3 extent  = { max.x - min.x, max.y - min.y, max.z - min.z };
+    const uint8_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0
+                         : extent.y >= extent.z                       ? 1
+                                                                      : 2;
+
+    const size_t middle = begin + (end - begin) / 2;
+    const auto key      = [&](const uint32_t i) {
+        return axis == 0 ? points[i].x : axis == 1 ? points[i].y : points[i].z;
+    };
+    std::ranges::nth_element(m_indices.begin() + begin, m_indices.begin() + middle,
+                             m_indices.begin() + end, {}, key);
+    m_axes[middle] = axis;
+
+    if (end - begin > PARALLEL_BUILD_SIZE) {
+        executor.parallelFor(2, [&](const size_t half) {
+            if (half == 0) build(points, begin, middle, executor);
+            else build(points, middle + 1, end, executor);
+        });
+    } else {
+        build(points, begin, middle, executor);
+        build(points, middle + 1, end, executor);
+    }
+}
+
+float KDTree::coordinate(const size_t index, const uint8_t axis) const
+{
+    return axis == 0 ? m_x[index] : axis == 1 ? m_y[index] : m_z[index];
+}
+
+template <typename Visit>
+void KDTree::search(const Vec3& query, const size_t begin, const size_t end,
+                    const float& maxDistanceSquared, Visit& visit) const
+{
+    if (end - begin <= LEAF_SIZE) {
+        size_t i = begin;
+#ifdef SOBJ_SSE2
+        // four points per step, visit only sees the ones that are close enough
+        const __m128 qx = _mm_set1_ps(query.x);
+        const __m128 qy = _mm_set1_ps(query.y);
+        const __m128 qz = _mm_set1_ps(query.z);
+        for (; i + 4 <= end; i += 4) {
+            const __m128 dx = _mm_sub_ps(_mm_loadu_ps(m_x.data() + i), qx);
+            const __m128 dy = _mm_sub_ps(_mm_loadu_ps(m_y.data() + i), qy);
+            const __m128 dz = _mm_sub_ps(_mm_loadu_ps(m_z.data() + i), qz);
+            const __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            int mask = _mm_movemask_ps(_mm_cmple_ps(distance, _mm_set1_ps(maxDistanceSquared)));
+            if (mask == 0) continue;
+
+            alignas(16) float distances[4];
+            _mm_store_ps(distances, distance);
+            for (; mask; mask &= mask - 1) {
+                const int lane = std::countr_zero(static_cast<unsigned>(mask));
+                visit(i + lane, distances[lane]);
+            }
+        }
+#endif
+        for (; i < end; i++) {
+            const float dx       = m_x[i] - query.x;
+            const float dy       = m_y[i] - query.y;
+            const float dz       = m_z[i] - query.z;
+            const float distance = dx * dx + dy * dy + dz * dz;
+            if (distance <= maxDistanceSquared) visit(i, distance);
+        }
+        return;
+    }
+
+    const size_t middle = begin + (end - begin) / 2;
+    const uint8_t axis  = m_axes[middle];
+    const float offset  = (axis == 0 ? query.x : axis == 1 ? query.y : query.z) -
+                         coordinate(middle, axis);
+
+    const float dx       = m_x[middle] - query.x;
+    const float dy       = m_y[middle] - query.y;
+    const float dz       = m_z[middle] - query.z;
+    const float distance = dx * dx + dy * dy + dz * dz;
+    if (distance <= maxDistanceSquared) visit(middle, distance);
+
+    // the near side first, it is the one most likely to shrink maxDistanceSquared
+    if (offset < 0.0f) {
+        search(query, begin, middle, maxDistanceSquared, visit);
+        if (offset * offset <= maxDistanceSquared) {
+            search(query, middle + 1, end, maxDistanceSquared, visit);
+        }
+    } else {
+        search(query, middle + 1, end, maxDistanceSquared, visit);
+        if (offset * offset <= maxDistanceSquared) {
+            search(query, begin, middle, maxDistanceSquared, visit);
+        }
+    }
+}
+
+std::vector<Neighbor> KDTree::nearest(const Vec3& query, const size_t k) const
+{
+    std::vector<Neighbor> heap{};
+    if (k == 0) return heap;
+    heap.reserve(std::min(k, size()));
+
+    const auto further = [](const Neighbor& a, const Neighbor& b) {
+        return a.distanceSquared < b.distanceSquared;
+    };
+    // the search prunes with this, it shrinks once k neighbours have been found
+    float maxDistanceSquared = std::numeric_limits<float>::infinity();
+    auto visit               = [&](const size_t i, const float distance) {
+        if (heap.size() == k) {
+            if (distance >= heap.front().distanceSquared) return;
+            std::ranges::pop_heap(heap, further);
+            heap.pop_back();
+        }
+        heap.push_back({ m_indices[i], distance });
+        std::ranges::push_heap(heap, further);
+        if (heap.size() == k) maxDistanceSquared = heap.front().distanceSquared;
+    };
+    search(query, 0, size(), maxDistanceSquared, visit);
+
+    std::ranges::sort_heap(heap, further);
+    return heap;
+}
+
+std::vector<Neighbor> KDTree::withinRadius(const Vec3& query, const float radius) const
+{
+    std::vector<Neighbor> neighbors{};
+    const float maxDistanceSquared = radius * radius;
+    auto visit = [&](const size_t i, const float distance) {
+        neighbors.push_back({ m_indices[i], distance });
+    };
+    search(query, 0, size(), maxDistanceSquared, visit);
+
+    std::ranges::sort(neighbors, {}, &Neighbor::distanceSquared);
+    return neighbors;
+}
+
+std::vector<std::vector<Neighbor>> KDTree::nearest(const std::span<const Vec3> queries,
+                                                   const size_t k,
+                                                   const std::shared_ptr<Executor>& executor) const
+{
+    detail::TraceScope trace{ "KDTree::nearest" };
+    std::vector<std::vector<Neighbor>> results(queries.size());
+    (executor ? executor : defaultExecutor())->parallelFor(queries.size(), [&](const size_t i) {
+        results[i] = nearest(queries[i], k);
+    });
+    return results;
+}
+
+std::vector<std::vector<Neighbor>> KDTree::withinRadius(
+    const std::span<const Vec3> queries, const float radius,
+    const std::shared_ptr<Executor>& executor) const
+{
+    detail::TraceScope trace{ "KDTree::withinRadius" };
+    std::vector<std::vector<Neighbor>> results(queries.size());
+    (executor ? executor : defaultExecutor())->parallelFor(queries.size(), [&](const size_t i) {
+        results[i] = withinRadius(queries[i], radius);
+    });
+    return results;
+}
+
+size_t KDTree::size() const
+{
+    return m_indices.size();
+}
+
+//--------------------------------------------------
+// MARK: Ambient Occlusion
+//--------------------------------------------------
+
+namespace detail
+{
+/// @brief Four rays sharing their origin, lanes that are done are masked out. Directions are
+/// unit length.
+struct RayPacket {
+    Vec3 origin{};
+    std::array<Vec3, 4> directions{};
+    std::array<Vec3, 4> inverseDirections{};
+    float maxDistance = 0.0f;
+};
+
+/// @brief Bounding volume hierarchy over triangles that only answers occlusion queries.
+class BVH
+{
+public:
+    BVH(const std::vector<Vec3>& positions, const std::vector<Mesh>& meshes);
+
+    /// @brief Returns the lanes of active that hit nothing, as a bit mask.
+    uint32_t unoccluded(const RayPacket& packet, uint32_t active) const;
+
+private:
+    static constexpr size_t LEAF_SIZE = 4;
+
+    struct Node {
+        Vec3 min{};
+        Vec3 max{};
+        uint32_t first = 0; // first triangle of a leaf, right child of an inner node
+        uint32_t count = 0; // 0 for inner nodes, their left child follows them directly
+    };
+
+    // precomputed for Moller-Trumbore
+    struct TriangleEdges {
+        Vec3 v0{};
+        Vec3 e1{};
+        Vec3 e2{};
+        // |e1| * |e2|, the largest determinant a unit direction can give
+        float scale = 0.0f;
+    };
+
+    std::vector<Node> m_nodes{};
+    std::vector<TriangleEdges> m_triangles{};
+
+    uint32_t build(std::vector<uint32_t>& order, const std::vector<Vec3>& centroids,
+                   const std::vector<TriangleEdges>& triangles, size_t begin, size_t end);
+    uint32_t hitBounds(const Node& node, const RayPacket& packet, uint32_t active) const;
+    static bool hitTriangle(const TriangleEdges& triangle, const Vec3& origin,
+                            const Vec3& direction, float maxDistance);
+};
+
+inline Vec3 add(const Vec3& a, const Vec3& b)
+{
+    return { a.x + b.x, a.y + b.y, a.z + b.z };
+}
 
-    if (!file.is_open()) { return false; }
+inline Vec3 subtract(const Vec3& a, const Vec3& b)
+{
+    return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
 
-    std::string line;
-    while (std::getline(file, line)) {
-        detail::trim(line);
+inline Vec3 minimum(const Vec3& a, const Vec3& b)
+{
+    return { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) };
+}
 
-        const Identifier id = identifier(line);
-        switch (id) {
-        case Identifier::NEW_MATERIAL: {
-            if (!parseNewMaterial(line)) return false;
-            break;
+inline Vec3 maximum(const Vec3& a, const Vec3& b)
+{
+    return { std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) };
+}
+
+inline Vec3 cross(const Vec3& a, const Vec3& b)
+{
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline float dot(const Vec3& a, const Vec3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vec3 normalized(const Vec3& v)
+{
+    const float length = std::sqrt(dot(v, v));
+    return length > 0.0f ? Vec3{ v.x / length, v.y / length, v.z / length } : Vec3{};
+}
+
+/// @brief Small fast generator, one per vertex so results do not depend on scheduling.
+inline uint32_t pcg(uint64_t& state)
+{
+    state               = state * 6364136223846793005ull + 1442695040888963407ull;
+    const auto xorshift = static_cast<uint32_t>(((state >> 18u) ^ state) >> 27u);
+    const auto rotation = static_cast<uint32_t>(state >> 59u);
+    return std::rotr(xorshift, static_cast<int>(rotation));
+}
+
+inline float uniformFloat(uint64_t& state)
+{
+    return static_cast<float>(pcg(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+BVH::BVH(const std::vector<Vec3>& positions, const std::vector<Mesh>& meshes)
+{
+    std::vector<TriangleEdges> triangles{};
+    std::vector<Vec3> centroids{};
+    for (const auto& mesh : meshes) {
+        for (const Triangle& triangle : TriangleView{ mesh }) {
+            const Vec3& a = positions[triangle.positionIndices[0]];
+            const Vec3& b = positions[triangle.positionIndices[1]];
+            const Vec3& c = positions[triangle.positionIndices[2]];
+            const Vec3 e1 = subtract(b, a);
+            const Vec3 e2 = subtract(c, a);
+            triangles.push_back({ a, e1, e2, std::sqrt(dot(e1, e1)) * std::sqrt(dot(e2, e2)) });
+            centroids.push_back({ (a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f,
+                                  (a.z + b.z + c.z) / 3.0f });
         }
-        case Identifier::AMBIENT_MAP: {
-            if (!materialExists()) return false;
-            if (!setImageMap(m_materials.back().alphaMapIndex, line, id)) { return false; }
-            break;
+    }
+    if (triangles.empty()) return;
+
+    std::vector<uint32_t> order(triangles.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    m_nodes.reserve(2 * triangles.size() / LEAF_SIZE + 1);
+    build(order, centroids, triangles, 0, triangles.size());
+
+    m_triangles.reserve(triangles.size());
+    for (const uint32_t i : order) {
+        m_triangles.push_back(triangles[i]);
+    }
+}
+
+uint32_t BVH::build(std::vector<uint32_t>& order, const std::vector<Vec3>& centroids,
+                    const std::vector<TriangleEdges>& triangles, const size_t begin,
+                    const size_t end)
+{
+    const auto index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    Node node{};
+    node.min = triangles[order[begin]].v0;
+    node.max = node.min;
+    Vec3 centroidMin = centroids[order[begin]];
+    Vec3 centroidMax = centroidMin;
+    for (size_t i = begin; i < end; i++) {
+        const TriangleEdges& triangle = triangles[order[i]];
+        for (const Vec3& v : { triangle.v0,
+                               add(triangle.v0, triangle.e1),
+                               add(triangle.v0, triangle.e2) }) {
+            node.min = minimum(node.min, v);
+            node.max = maximum(node.max, v);
         }
-        case Identifier::DIFFUSE_MAP: {
-            if (!materialExists()) return false;
-            if (!setImageMap(m_materials.back().diffuseMapIndex, line, id)) { return false; }
-            break;
+        centroidMin = minimum(centroidMin, centroids[order[i]]);
+        centroidMax = maximum(centroidMax, centroids[order[i]]);
+    }
+
+    if (end - begin <= LEAF_SIZE) {
+        node.first     = static_cast<uint32_t>(begin);
+        node.count     = static_cast<uint32_t>(end - begin);
+        m_nodes[index] = node;
+        return index;
+    }
+
+    // median split along the widest spread of centroids
+    const Vec3 extent   = subtract(centroidMax, centroidMin);
+    const int axis      = extent.x >= extent.y && extent.x >= extent.z ? 0
+                         : extent.y >= extent.z                       ? 1
+                                                                      : 2;
+    const size_t middle = begin + (end - begin) / 2;
+    std::ranges::nth_element(
+        order.begin() + begin, order.begin() + middle, order.begin() + end, {},
+        [&](const uint32_t i) {
+            return axis == 0 ? centroids[i].x : axis == 1 ? centroids[i].y : centroids[i].z;
+        });
+
+    build(order, centroids, triangles, begin, middle);
+    node.first     = build(order, centroids, triangles, middle, end);
+    m_nodes[index] = node;
+    return index;
+}
+
+uint32_t BVH::hitBounds(const Node& node, const RayPacket& packet, const uint32_t active) const
+{
+#ifdef SOBJ_SSE2
+    // a lane with an origin on a slab plane and a direction of 0 along its axis gets 0 * inf,
+    // that ray runs along the face of the box and keeps its interval
+    const auto slab = [&](const float min, const float max, const float origin,
+                          const __m128 inverse, __m128& near, __m128& far) {
+        const __m128 t0  = _mm_mul_ps(_mm_set1_ps(min - origin), inverse);
+        const __m128 t1  = _mm_mul_ps(_mm_set1_ps(max - origin), inverse);
+        const __m128 nan = _mm_or_ps(_mm_cmpunord_ps(t0, t0), _mm_cmpunord_ps(t1, t1));
+        near = _mm_or_ps(_mm_and_ps(nan, near),
+                         _mm_andnot_ps(nan, _mm_max_ps(near, _mm_min_ps(t0, t1))));
+        far  = _mm_or_ps(_mm_and_ps(nan, far),
+                         _mm_andnot_ps(nan, _mm_min_ps(far, _mm_max_ps(t0, t1))));
+    };
+    const auto& inverse = packet.inverseDirections;
+    __m128 near         = _mm_setzero_ps();
+    __m128 far          = _mm_set1_ps(packet.maxDistance);
+    slab(node.min.x, node.max.x, packet.origin.x,
+         _mm_setr_ps(inverse[0].x, inverse[1].x, inverse[2].x, inverse[3].x), near, far);
+    slab(node.min.y, node.max.y, packet.origin.y,
+         _mm_setr_ps(inverse[0].y, inverse[1].y, inverse[2].y, inverse[3].y), near, far);
+    slab(node.min.z, node.max.z, packet.origin.z,
+         _mm_setr_ps(inverse[0].z, inverse[1].z, inverse[2].z, inverse[3].z), near, far);
+    return active & static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(near, far)));
+#else
+    uint32_t hits = 0;
+    for (uint32_t lane = 0; lane < 4; lane++) {
+        if (!(active & (1u << lane))) continue;
+        const Vec3& inverse = packet.inverseDirections[lane];
+        float near          = 0.0f;
+        float far           = packet.maxDistance;
+        for (const auto& [min, max, origin, inv] :
+             { std::array{ node.min.x, node.max.x, packet.origin.x, inverse.x },
+               std::array{ node.min.y, node.max.y, packet.origin.y, inverse.y },
+               std::array{ node.min.z, node.max.z, packet.origin.z, inverse.z } }) {
+            const float t0 = (min - origin) * inv;
+            const float t1 = (max - origin) * inv;
+            // the ray runs along the face of the box, see above
+            if (std::isnan(t0) || std::isnan(t1)) continue;
+            near = std::max(near, std::min(t0, t1));
+            far  = std::min(far, std::max(t0, t1));
         }
-        case Identifier::SPECULAR_MAP: {
-            if (!materialExists()) return false;
-            if (!setImageMap(m_materials.back().specularMapIndex, line, id)) { return false; }
-            break;
+        if (near <= far) hits |= 1u << lane;
+    }
+    return hits;
+#endif
+}
+
+bool BVH::hitTriangle(const TriangleEdges& triangle, const Vec3& origin, const Vec3& direction,
+                      const float maxDistance)
+{
+    // relative to the edge lengths, so the parallel test does not depend on the mesh scale
+    constexpr float EPSILON = 1e-6f;
+    const Vec3 p            = cross(direction, triangle.e2);
+    const float determinant = dot(triangle.e1, p);
+    if (std::abs(determinant) <= EPSILON * triangle.scale) return false;
+
+    const float inverse = 1.0f / determinant;
+    const Vec3 s        = subtract(origin, triangle.v0);
+    const float u       = dot(s, p) * inverse;
+    if (u < 0.0f || u > 1.0f) return false;
+    const Vec3 q  = cross(s, triangle.e1);
+    const float v = dot(direction, q) * inverse;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    const float t = dot(triangle.e2, q) * inverse;
+    return t > 0.0f && t <= maxDistance;
+}
+
+uint32_t BVH::unoccluded(const RayPacket& packet, uint32_t active) const
+{
+    if (m_nodes.empty()) return active;
+
+    // the tree is balanced, so its depth stays far below the stack size
+    std::array<uint32_t, 64> stack{};
+    size_t size   = 0;
+    stack[size++] = 0;
+    while (size > 0 && active) {
+        const Node& node     = m_nodes[stack[--size]];
+        const uint32_t lanes = hitBounds(node, packet, active);
+        if (!lanes) continue;
+
+        if (node.count == 0) {
+            const auto index = static_cast<uint32_t>(&node - m_nodes.data());
+            stack[size++]    = node.first;
+            stack[size++]    = index + 1;
+            continue;
         }
-        case Identifier::ROUGHNESS_MAP: {
-            if (!materialExists()) return false;
-            if (!setImageMap(m_materials.back().roughnessMapIndex, line, id)) { return false; }
-            break;
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            for (uint32_t remaining = lanes & active; remaining; remaining &= remaining - 1) {
+                const int lane = std::countr_zero(remaining);
+                if (hitTriangle(m_triangles[i], packet.origin, packet.directions[lane],
+                                packet.maxDistance)) {
+                    active &= ~(1u << lane);
+                }
+            }
         }
-        case Identifier::ALPHA_MAP: {
-            if (!materialExists()) return false;
-            if (!setImageMap(m_materials.back().ambientMapIndex, line, id)) { return false; }
-            break;
+    }
+    return active;
+}
+} // namespace detail
+
+void bakeAmbientOcclusion(OBJData& data, const AmbientOcclusionSettings& settings,
+                          const std::shared_ptr<Executor>& executor)
+{
+    detail::TraceScope trace{ "bakeAmbientOcclusion" };
+    const detail::BVH bvh{ data.positions, data.meshes };
+
+    // area weighted vertex normals, the loaded ones may be split per face
+    std::vector<Vec3> normals(data.positions.size());
+    for (const auto& mesh : data.meshes) {
+        for (const Triangle& triangle : TriangleView{ mesh }) {
+            const auto& [a, b, c] = triangle.positionIndices;
+            const Vec3 ab         = detail::subtract(data.positions[b], data.positions[a]);
+            const Vec3 ac         = detail::subtract(data.positions[c], data.positions[a]);
+            const Vec3 normal     = detail::cross(ab, ac);
+            for (const uint32_t index : triangle.positionIndices) {
+                normals[index] = detail::add(normals[index], normal);
+            }
         }
-        case Identifier::AMBIENT: {
-            if (!materialExists()) return false;
-            const auto result = m_mathParser.parseVec3(line);
-            if (!result) {
-                m_logger->error(std::format(
-                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
-                return false;
+    }
+
+    data.colors.assign(data.positions.size(), Vec3{ 1.0f, 1.0f, 1.0f });
+    const uint32_t rayCount = std::max<uint32_t>(1, settings.rayCount);
+    const auto pool         = executor ? executor : defaultExecutor();
+    pool->parallelFor(data.positions.size(), [&](const size_t i) {
+        const Vec3 normal = detail::normalized(normals[i]);
+        if (detail::dot(normal, normal) == 0.0f) return;
+
+        // tangent frame around the normal
+        const Vec3 helper    = std::abs(normal.x) > 0.9f ? Vec3{ 0, 1, 0 } : Vec3{ 1, 0, 0 };
+        const Vec3 tangent   = detail::normalized(detail::cross(helper, normal));
+        const Vec3 bitangent = detail::cross(normal, tangent);
+
+        detail::RayPacket packet{};
+        packet.origin      = { data.positions[i].x + normal.x * settings.bias,
+                               data.positions[i].y + normal.y * settings.bias,
+                               data.positions[i].z + normal.z * settings.bias };
+        packet.maxDistance = settings.maxDistance;
+
+        uint64_t state      = (static_cast<uint64_t>(settings.seed) << 32) ^ i;
+        uint32_t unoccluded = 0;
+        for (uint32_t ray = 0; ray < rayCount; ray += 4) {
+            const uint32_t lanes = std::min<uint32_t>(4, rayCount - ray);
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                // cosine weighted, so every unoccluded ray counts the same
+                const float radius   = std::sqrt(detail::uniformFloat(state));
+                const float angle    = std::numbers::pi_v<float> * 2 * detail::uniformFloat(state);
+                const float x        = radius * std::cos(angle);
+                const float y        = radius * std::sin(angle);
+                const float z        = std::sqrt(std::max(0.0f, 1.0f - x * x - y * y));
+                const Vec3 direction = { tangent.x * x + bitangent.x * y + normal.x * z,
+                                         tangent.y * x + bitangent.y * y + normal.y * z,
+                                         tangent.z * x + bitangent.z * y + normal.z * z };
+                packet.directions[lane]        = direction;
+                packet.inverseDirections[lane] = { 1.0f / direction.x, 1.0f / direction.y,
+                                                   1.0f / direction.z };
             }
-            m_materials.back().ambient = result;
-            break;
+            const uint32_t active = (1u << lanes) - 1;
+            unoccluded += std::popcount(bvh.unoccluded(packet, active));
         }
-        case Identifier::DIFFUSE: {
-            if (!materialExists()) return false;
-            const auto result = m_mathParser.parseVec3(line);
-            if (!result) {
-                m_logger->error(std::format(
-                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
-                return false;
+
+        const float visibility = static_cast<float>(unoccluded) / static_cast<float>(rayCount);
+        data.colors[i]         = { visibility, visibility, visibility };
+    });
+
+    for (auto& mesh : data.meshes) {
+        for (auto& face : mesh.faces) {
+            face.colorIndices = face.positionIndices;
+        }
+    }
+}
+
+//--------------------------------------------------
+// MARK: Repair
+//--------------------------------------------------
+
+namespace detail
+{
+struct HalfEdge {
+    uint64_t key  = 0; // both vertices, smaller one in the upper half
+    uint32_t face = 0;
+    uint32_t from = 0;
+    uint32_t to   = 0;
+};
+
+struct FaceNeighbor {
+    uint32_t face = 0;
+    // both faces walk the shared edge in the same direction, so one of them is flipped
+    bool sameDirection = false;
+};
+
+/// @brief Faces sharing a manifold edge, in compressed rows per face.
+struct FaceAdjacency {
+    std::vector<uint32_t> offsets{};
+    std::vector<FaceNeighbor> neighbors{};
+    std::vector<HalfEdge> boundary{};
+    size_t nonManifoldEdges = 0;
+};
+
+inline FaceAdjacency faceAdjacency(const Mesh& mesh)
+{
+    std::vector<HalfEdge> edges{};
+    for (uint32_t f = 0; f < mesh.faces.size(); f++) {
+        const auto& indices = mesh.faces[f].positionIndices;
+        for (size_t i = 0; i < indices.size(); i++) {
+            const uint32_t from = indices[i];
+            const uint32_t to   = indices[(i + 1) % indices.size()];
+            if (from == to) continue;
+            const uint64_t key = static_cast<uint64_t>(std::min(from, to)) << 32 |
+                                 std::max(from, to);
+            edges.push_back({ key, f, from, to });
+        }
+    }
+    std::ranges::sort(edges, {}, &HalfEdge::key);
+
+    FaceAdjacency adjacency{};
+    std::vector<std::pair<uint32_t, FaceNeighbor>> pairs{};
+    for (size_t begin = 0; begin < edges.size();) {
+        size_t end = begin + 1;
+        while (end < edges.size() && edges[end].key == edges[begin].key) end++;
+
+        if (end - begin == 1) {
+            adjacency.boundary.push_back(edges[begin]);
+        } else if (end - begin > 2) {
+            adjacency.nonManifoldEdges++;
+        } else if (edges[begin].face != edges[begin + 1].face) {
+            const HalfEdge& a = edges[begin];
+            const HalfEdge& b = edges[begin + 1];
+            const bool same   = a.from == b.from;
+            pairs.push_back({ a.face, { b.face, same } });
+            pairs.push_back({ b.face, { a.face, same } });
+        }
+        begin = end;
+    }
+
+    adjacency.offsets.assign(mesh.faces.size() + 1, 0);
+    for (const auto& [face, _] : pairs) {
+        adjacency.offsets[face + 1]++;
+    }
+    for (size_t i = 1; i < adjacency.offsets.size(); i++) {
+        adjacency.offsets[i] += adjacency.offsets[i - 1];
+    }
+    adjacency.neighbors.resize(pairs.size());
+    std::vector<uint32_t> cursor{ adjacency.offsets.begin(), adjacency.offsets.end() - 1 };
+    for (const auto& [face, neighbor] : pairs) {
+        adjacency.neighbors[cursor[face]++] = neighbor;
+    }
+    return adjacency;
+}
+
+inline void flipFace(Face& face)
+{
+    std::ranges::reverse(face.positionIndices);
+    std::ranges::reverse(face.normalIndices);
+    std::ranges::reverse(face.uvIndices);
+    std::ranges::reverse(face.colorIndices);
+}
+
+enum FaceState : uint8_t { UNVISITED, KEPT, FLIPPED };
+
+/// @brief Orients the faces of every component the same way. Returns the number of
+/// components, flipped faces and components that can not be oriented.
+inline std::array<size_t, 3> orientFaces(Mesh& mesh, const FaceAdjacency& adjacency,
+                                         Executor& executor)
+{
+    // frontiers smaller than this are cheaper to walk on the calling thread
+    constexpr size_t PARALLEL_FRONTIER_SIZE = 1024;
+    constexpr size_t FRONTIER_CHUNK_SIZE    = 256;
+
+    const size_t numFaces = mesh.faces.size();
+    std::vector<std::atomic<uint8_t>> states(numFaces);
+    std::array<size_t, 3> result{};
+    auto& [components, flipped, nonOrientable] = result;
+
+    std::vector<uint32_t> component{};
+    std::vector<uint32_t> frontier{};
+    std::vector<uint32_t> next{};
+    std::mutex nextMutex{};
+    std::atomic<bool> conflict = false;
+
+    // claims every unvisited neighbour, the state a neighbour should have follows from ours
+    const auto visit = [&](const size_t begin, const size_t end, std::vector<uint32_t>& out) {
+        for (size_t i = begin; i < end; i++) {
+            const uint32_t face   = frontier[i];
+            const uint8_t current = states[face].load(std::memory_order_relaxed);
+            for (uint32_t n = adjacency.offsets[face]; n < adjacency.offsets[face + 1]; n++) {
+                const FaceNeighbor& neighbor = adjacency.neighbors[n];
+                const uint8_t wanted = neighbor.sameDirection == (current == KEPT) ? FLIPPED : KEPT;
+                uint8_t state        = UNVISITED;
+                if (states[neighbor.face].compare_exchange_strong(state, wanted,
+                                                                  std::memory_order_relaxed)) {
+                    out.push_back(neighbor.face);
+                } else if (state != wanted) {
+                    conflict.store(true, std::memory_order_relaxed);
+                }
             }
-            m_materials.back().diffuse = result;
-            break;
         }
-        case Identifier::SPECULAR: {
-            if (!materialExists()) return false;
-            const auto result = m_mathParser.parseVec3(line);
-            if (!result) {
-                m_logger->error(std::format(
-                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
-                return false;
+    };
+
+    for (uint32_t seed = 0; seed < numFaces; seed++) {
+        if (states[seed].load(std::memory_order_relaxed) != UNVISITED) continue;
+        states[seed].store(KEPT, std::memory_order_relaxed);
+        components++;
+        component.clear();
+        frontier.assign(1, seed);
+        conflict.store(false, std::memory_order_relaxed);
+
+        // level synchronous, each level only starts once the previous one is done
+        while (!frontier.empty()) {
+            component.insert(component.end(), frontier.begin(), frontier.end());
+            next.clear();
+            if (frontier.size() < PARALLEL_FRONTIER_SIZE) {
+                visit(0, frontier.size(), next);
+            } else {
+                const size_t chunks = (frontier.size() + FRONTIER_CHUNK_SIZE - 1) /
+                                      FRONTIER_CHUNK_SIZE;
+                executor.parallelFor(chunks, [&](const size_t chunk) {
+                    std::vector<uint32_t> local{};
+                    const size_t begin = chunk * FRONTIER_CHUNK_SIZE;
+                    visit(begin, std::min(begin + FRONTIER_CHUNK_SIZE, frontier.size()), local);
+                    std::lock_guard lock{ nextMutex };
+                    next.insert(next.end(), local.begin(), local.end());
+                });
             }
-            m_materials.back().specular = result;
-            break;
+            std::swap(frontier, next);
         }
-        case Identifier::ROUGHNESS: {
-            if (!materialExists()) return false;
-            const auto result = m_mathParser.parseFloat(line);
-            if (!result) {
-                m_logger->error(std::format(
-                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
-                return false;
+
+        if (conflict.load(std::memory_order_relaxed)) nonOrientable++;
+        // keep whichever winding most faces of the component already have
+        const auto numFlipped = static_cast<size_t>(std::ranges::count_if(
+            component, [&](const uint32_t face) { return states[face].load() == FLIPPED; }));
+        if (numFlipped * 2 > component.size()) {
+            for (const uint32_t face : component) {
+                states[face].store(states[face].load() == FLIPPED ? KEPT : FLIPPED);
             }
-            m_materials.back().roughness = result;
-            break;
         }
-        case Identifier::ALPHA: {
-            if (!materialExists()) return false;
-            const auto result = m_mathParser.parseFloat(line);
-            if (!result) {
-                m_logger->error(std::format(
-                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
-                return false;
-            }
-            m_materials.back().alpha = result;
-            break;
+    }
+
+    executor.parallelFor(numFaces, [&](const size_t face) {
+        if (states[face].load(std::memory_order_relaxed) == FLIPPED) flipFace(mesh.faces[face]);
+    });
+    for (const auto& state : states) {
+        if (state.load(std::memory_order_relaxed) == FLIPPED) flipped++;
+    }
+    return result;
+}
+
+/// @brief Fills the boundary loops of the mesh. Boundary edges come from the already oriented
+/// faces, loops walk them backwards so the new faces match their neighbours. New corners take
+/// their normal, uv and color indices from the corner of the face on the hole's boundary.
+/// Returns the number of filled holes, added faces and skipped holes.
+inline std::array<size_t, 3> fillHoles(Mesh& mesh, const std::vector<HalfEdge>& boundary,
+                                       const size_t maxHoleSize)
+{
+    std::array<size_t, 3> result{};
+    auto& [filled, added, skipped] = result;
+
+    // vertices with more than one outgoing boundary edge make loops ambiguous
+    std::unordered_map<uint32_t, uint32_t> next{};
+    std::unordered_set<uint32_t> ambiguous{};
+    // face and corner the boundary edge ending at a vertex belongs to
+    std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> corners{};
+    for (const HalfEdge& edge : boundary) {
+        if (!next.emplace(edge.to, edge.from).second) {
+            ambiguous.insert(edge.to);
+            continue;
+        }
+        const auto& indices = mesh.faces[edge.face].positionIndices;
+        const auto corner   = std::ranges::find(indices, edge.to) - indices.begin();
+        corners.emplace(edge.to, std::pair{ edge.face, static_cast<uint32_t>(corner) });
+    }
+
+    // left empty if any of the faces around the new one lacks the attribute
+    const auto copyCorners = [&](Face& face, std::vector<uint32_t> Face::* attribute) {
+        std::vector<uint32_t> indices{};
+        for (const uint32_t vertex : face.positionIndices) {
+            const auto [source, corner] = corners.at(vertex);
+            const auto& sourceIndices   = mesh.faces[source].*attribute;
+            if (sourceIndices.empty()) return;
+            indices.push_back(sourceIndices[corner]);
+        }
+        face.*attribute = std::move(indices);
+    };
+
+    std::unordered_set<uint32_t> used{};
+    std::vector<uint32_t> loop{};
+    for (const HalfEdge& edge : boundary) {
+        if (used.contains(edge.to)) continue;
+
+        loop.assign(1, edge.to);
+        used.insert(edge.to);
+        bool closed  = false;
+        bool invalid = ambiguous.contains(edge.to);
+        for (uint32_t vertex = edge.from;; vertex = next.at(vertex)) {
+            if (vertex == edge.to) {
+                closed = true;
+                break;
+            }
+            if (!next.contains(vertex) || used.contains(vertex)) break;
+            invalid |= ambiguous.contains(vertex);
+            used.insert(vertex);
+            loop.push_back(vertex);
+        }
+
+        if (!closed || invalid || loop.size() > maxHoleSize) {
+            skipped++;
+            continue;
+        }
+        if (loop.size() < 3) continue;
+
+        for (size_t i = 1; i + 1 < loop.size(); i++) {
+            Face face{};
+            face.positionIndices = { loop[0], loop[i], loop[i + 1] };
+            copyCorners(face, &Face::normalIndices);
+            copyCorners(face, &Face::uvIndices);
+            copyCorners(face, &Face::colorIndices);
+            mesh.faces.push_back(std::move(face));
+            added++;
+        }
+        filled++;
+    }
+    return result;
+}
+} // namespace detail
+
+RepairReport repair(OBJData& data, const RepairSettings& settings,
+                    const std::shared_ptr<Executor>& executor)
+{
+    detail::TraceScope trace{ "repair" };
+    Executor& pool = *(executor ? executor : defaultExecutor());
+
+    RepairReport report{};
+    for (auto& mesh : data.meshes) {
+        const detail::FaceAdjacency adjacency = detail::faceAdjacency(mesh);
+        report.nonManifoldEdges += adjacency.nonManifoldEdges;
+
+        if (settings.orientFaces) {
+            const auto [components, flipped, nonOrientable] =
+                detail::orientFaces(mesh, adjacency, pool);
+            report.components += components;
+            report.flippedFaces += flipped;
+            report.nonOrientableComponents += nonOrientable;
+        }
+
+        if (settings.fillHoles) {
+            // flipping reversed some boundary edges
+            std::vector<detail::HalfEdge> boundary = adjacency.boundary;
+            if (settings.orientFaces) {
+                for (auto& edge : boundary) {
+                    const auto& indices = mesh.faces[edge.face].positionIndices;
+                    const auto from     = std::ranges::find(indices, edge.from);
+                    const auto to       = std::next(from) == indices.end() ? indices.begin()
+                                                                           : std::next(from);
+                    if (*to != edge.to) std::swap(edge.from, edge.to);
+                }
+            }
+
+            const auto [filled, added, skipped] =
+                detail::fillHoles(mesh, boundary, settings.maxHoleSize);
+            report.filledHoles += filled;
+            report.addedFaces += added;
+            report.skippedHoles += skipped;
+        }
+    }
+    return report;
+}
+
+//--------------------------------------------------
+// MARK: Memory Footprint
+//--------------------------------------------------
+
+void MemoryTracker::allocate(const size_t bytes)
+{
+    const size_t current = m_current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak          = m_peak.load(std::memory_order_relaxed);
+    while (current > peak && !m_peak.compare_exchange_weak(peak, current)) {
+    }
+}
+
+void MemoryTracker::release(const size_t bytes)
+{
+    m_current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::peak() const
+{
+    return m_peak.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::reset()
+{
+    m_current.store(0, std::memory_order_relaxed);
+    m_peak.store(0, std::memory_order_relaxed);
+}
+
+namespace detail
+{
+MemoryUsage meshMemoryUsage(const Mesh& mesh)
+{
+    MemoryUsage usage = memoryUsage(mesh.groups);
+    usage += memoryUsage(mesh.smoothingGroups);
+    return usage;
+}
+
+MemoryUsage faceMemoryUsage(const Mesh& mesh)
+{
+    MemoryUsage usage = memoryUsage(mesh.faces);
+    for (const auto& face : mesh.faces) {
+        usage += memoryUsage(face.positionIndices);
+        usage += memoryUsage(face.normalIndices);
+        usage += memoryUsage(face.uvIndices);
+        usage += memoryUsage(face.colorIndices);
+    }
+    return usage;
+}
+
+MemoryUsage imageMemoryUsage(const std::vector<ImageData>& images)
+{
+    MemoryUsage usage = memoryUsage(images);
+    for (const auto& image : images) {
+        usage += memoryUsage(image.bytes);
+    }
+    return usage;
+}
+} // namespace detail
+
+MemoryFootprint memoryFootprint(const OBJData& data)
+{
+    MemoryFootprint footprint{};
+    footprint.positions  = detail::memoryUsage(data.positions);
+    footprint.normals    = detail::memoryUsage(data.normals);
+    footprint.textureUVs = detail::memoryUsage(data.textureUVs);
+    footprint.colors     = detail::memoryUsage(data.colors);
+    footprint.meshes     = detail::memoryUsage(data.meshes);
+    footprint.meshFaces.reserve(data.meshes.size());
+    for (const auto& mesh : data.meshes) {
+        footprint.meshes += detail::meshMemoryUsage(mesh);
+        footprint.meshFaces.push_back(detail::faceMemoryUsage(mesh));
+        footprint.faces += footprint.meshFaces.back();
+    }
+    footprint.materials = detail::memoryUsage(data.materials);
+    footprint.images    = detail::imageMemoryUsage(data.images);
+    footprint.names     = data.names.memoryUsage();
+    footprint.names += detail::memoryUsage(data.name);
+    return footprint;
+}
+
+#ifdef SOBJ_POSIX
+//--------------------------------------------------
+// MARK: Shared Memory
+//--------------------------------------------------
+
+namespace detail
+{
+/// @brief Hands out aligned offsets into a segment that is yet to be created.
+class SharedLayout
+{
+public:
+    template <typename T> SharedArray add(const size_t count)
+    {
+        constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+        m_size                     = (m_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        const SharedArray array{ m_size, count };
+        m_size += count * sizeof(T);
+        return array;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    size_t m_size = sizeof(SharedHeader);
+};
+
+template <typename T> T* sharedArray(char* segment, const SharedArray& array)
+{
+    return reinterpret_cast<T*>(segment + array.offset);
+}
+
+template <typename T> void writeShared(char* segment, const SharedArray& array, const T* data)
+{
+    if (array.count > 0) std::memcpy(segment + array.offset, data, array.count * sizeof(T));
+}
+
+bool usesIndices(const Mesh& mesh, std::vector<uint32_t> Face::* indices)
+{
+    return std::ranges::any_of(mesh.faces, [&](const Face& face) {
+        return !(face.*indices).empty();
+    });
+}
+
+void writeFaceIndices(char* segment, const Mesh& mesh, const SharedArray& array,
+                      std::vector<uint32_t> Face::* indices)
+{
+    if (array.count == 0) return;
+    uint32_t* out = sharedArray<uint32_t>(segment, array);
+    for (const auto& face : mesh.faces) {
+        const auto& faceIndices = face.*indices;
+        if (faceIndices.empty()) {
+            out = std::fill_n(out, face.numVertices(), NO_INDEX);
+        } else {
+            out = std::ranges::copy(faceIndices, out).out;
+        }
+    }
+}
+} // namespace detail
+
+std::optional<SharedOBJData> SharedOBJData::publish(const OBJData& data, const std::string& name,
+                                                    const mode_t mode)
+{
+    detail::TraceScope trace{ "SharedOBJData::publish" };
+
+    detail::SharedLayout layout{};
+    detail::SharedHeader header{};
+    header.name       = layout.add<char>(data.name.size());
+    header.positions  = layout.add<Vec3>(data.positions.size());
+    header.normals    = layout.add<Vec3>(data.normals.size());
+    header.textureUVs = layout.add<Vec2>(data.textureUVs.size());
+    header.colors     = layout.add<Vec3>(data.colors.size());
+    header.materials  = layout.add<Material>(data.materials.size());
+
+    header.meshes = layout.add<detail::SharedMesh>(data.meshes.size());
+    std::vector<detail::SharedMesh> meshes(data.meshes.size());
+    for (size_t i = 0; i < data.meshes.size(); i++) {
+        const Mesh& mesh = data.meshes[i];
+        size_t vertices  = 0;
+        for (const auto& face : mesh.faces) {
+            vertices += face.numVertices();
+        }
+        const auto indices = [&](std::vector<uint32_t> Face::* attribute) {
+            return layout.add<uint32_t>(detail::usesIndices(mesh, attribute) ? vertices : 0);
+        };
+
+        meshes[i].name            = mesh.name;
+        meshes[i].materialIndex   = mesh.materialIndex.value_or(detail::NO_INDEX);
+        meshes[i].unifiedIndices  = mesh.unifiedIndices;
+        meshes[i].groups          = layout.add<NameID>(mesh.groups.size());
+        meshes[i].faceOffsets     = layout.add<uint32_t>(mesh.faces.size() + 1);
+        meshes[i].positionIndices = indices(&Face::positionIndices);
+        meshes[i].normalIndices   = indices(&Face::normalIndices);
+        meshes[i].uvIndices       = indices(&Face::uvIndices);
+        meshes[i].colorIndices    = indices(&Face::colorIndices);
+        meshes[i].smoothingGroups = layout.add<SmoothingRun>(mesh.smoothingGroups.size());
+    }
+
+    header.images = layout.add<detail::SharedImage>(data.images.size());
+    std::vector<detail::SharedImage> images(data.images.size());
+    for (size_t i = 0; i < data.images.size(); i++) {
+        const ImageData& image = data.images[i];
+        images[i]              = { image.name, image.width, image.height, image.channels, {} };
+        images[i].bytes        = layout.add<unsigned char>(image.bytes.size());
+    }
+
+    size_t nameBytes = 0;
+    for (NameID id = 0; id < data.names.size(); id++) {
+        nameBytes += data.names.view(id).size();
+    }
+    header.nameOffsets = layout.add<uint64_t>(data.names.size() + 1);
+    header.nameBytes   = layout.add<char>(nameBytes);
+    header.size        = layout.size();
+
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, mode);
+    if (fd < 0) return std::nullopt;
+    void* mapping = MAP_FAILED;
+    // shm_open applies the umask, which would take away the write bit attach needs
+    if (fchmod(fd, mode) == 0 && ftruncate(fd, static_cast<off_t>(header.size)) == 0) {
+        mapping = mmap(nullptr, header.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+
+    char* segment = static_cast<char*>(mapping);
+    detail::writeShared(segment, header.name, data.name.data());
+    detail::writeShared(segment, header.positions, data.positions.data());
+    detail::writeShared(segment, header.normals, data.normals.data());
+    detail::writeShared(segment, header.textureUVs, data.textureUVs.data());
+    detail::writeShared(segment, header.colors, data.colors.data());
+    detail::writeShared(segment, header.materials, data.materials.data());
+    detail::writeShared(segment, header.meshes, meshes.data());
+    detail::writeShared(segment, header.images, images.data());
+
+    for (size_t i = 0; i < data.meshes.size(); i++) {
+        const Mesh& mesh = data.meshes[i];
+        detail::writeShared(segment, meshes[i].groups, mesh.groups.data());
+        detail::writeShared(segment, meshes[i].smoothingGroups, mesh.smoothingGroups.data());
+
+        uint32_t* offsets = detail::sharedArray<uint32_t>(segment, meshes[i].faceOffsets);
+        offsets[0]        = 0;
+        for (size_t f = 0; f < mesh.faces.size(); f++) {
+            offsets[f + 1] = offsets[f] + static_cast<uint32_t>(mesh.faces[f].numVertices());
         }
-        case Identifier::COMMENT:
-        case Identifier::BLANK:
-            break;
-        case Identifier::UNKNOWN:
-            m_logger->warn(
-                std::format("Unknown identifier encountered in {} at line {}", m_filePath, m_line));
-            break;
+        detail::writeFaceIndices(segment, mesh, meshes[i].positionIndices, &Face::positionIndices);
+        detail::writeFaceIndices(segment, mesh, meshes[i].normalIndices, &Face::normalIndices);
+        detail::writeFaceIndices(segment, mesh, meshes[i].uvIndices, &Face::uvIndices);
+        detail::writeFaceIndices(segment, mesh, meshes[i].colorIndices, &Face::colorIndices);
+    }
+
+    for (size_t i = 0; i < data.images.size(); i++) {
+        detail::writeShared(segment, images[i].bytes, data.images[i].bytes.data());
+    }
+
+    uint64_t* nameOffsets = detail::sharedArray<uint64_t>(segment, header.nameOffsets);
+    char* names           = detail::sharedArray<char>(segment, header.nameBytes);
+    nameOffsets[0]        = 0;
+    for (NameID id = 0; id < data.names.size(); id++) {
+        const auto view = data.names.view(id);
+        std::ranges::copy(view, names + nameOffsets[id]);
+        nameOffsets[id + 1] = nameOffsets[id] + view.size();
+    }
+
+    // the publisher holds the first reference, magic goes last so attach never sees a
+    // partially written segment
+    auto* shared = new (segment) detail::SharedHeader{};
+    shared->version      = header.version;
+    shared->size         = header.size;
+    shared->materialSize = header.materialSize;
+    shared->name         = header.name;
+    shared->positions    = header.positions;
+    shared->normals      = header.normals;
+    shared->textureUVs   = header.textureUVs;
+    shared->colors       = header.colors;
+    shared->meshes       = header.meshes;
+    shared->materials    = header.materials;
+    shared->images       = header.images;
+    shared->nameOffsets  = header.nameOffsets;
+    shared->nameBytes    = header.nameBytes;
+    shared->references.store(1, std::memory_order_relaxed);
+    shared->magic.store(detail::SHARED_MAGIC, std::memory_order_release);
+    munmap(mapping, header.size);
+
+    auto result = map(fd, name);
+    close(fd);
+    if (!result) shm_unlink(name.c_str());
+    return result;
+}
+
+std::optional<SharedOBJData> SharedOBJData::attach(const std::string& name)
+{
+    // read write only so the reference count can be updated, the data is mapped read only
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) return std::nullopt;
+    auto result = map(fd, name);
+    close(fd);
+    if (!result) return std::nullopt;
+
+    // a count of 0 means the last handle is being released and the segment is going away
+    auto& references = result->m_header->references;
+    uint32_t count   = references.load(std::memory_order_relaxed);
+    do {
+        if (count == 0) {
+            munmap(result->m_header, sizeof(detail::SharedHeader));
+            result->m_header = nullptr;
+            return std::nullopt;
         }
+    } while (!references.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel));
 
-        m_line++;
+    return result;
+}
+
+std::optional<SharedOBJData> SharedOBJData::map(const int fd, const std::string& name)
+{
+    struct stat info{};
+    if (fstat(fd, &info) != 0) return std::nullopt;
+    const auto size = static_cast<size_t>(info.st_size);
+    if (size < sizeof(detail::SharedHeader)) return std::nullopt;
+
+    void* header = mmap(nullptr, sizeof(detail::SharedHeader), PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED) return std::nullopt;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        munmap(header, sizeof(detail::SharedHeader));
+        return std::nullopt;
     }
 
-    return true;
+    SharedOBJData shared{};
+    shared.m_segmentName = name;
+    shared.m_data        = static_cast<const char*>(data);
+    shared.m_header      = static_cast<detail::SharedHeader*>(header);
+    shared.m_size        = size;
+
+    const auto& layout = *shared.m_header;
+    if (layout.magic.load(std::memory_order_acquire) != detail::SHARED_MAGIC ||
+        layout.version != detail::SHARED_VERSION || layout.size != size ||
+        layout.materialSize != sizeof(Material)) {
+        // not ours to release, we never took a reference
+        munmap(header, sizeof(detail::SharedHeader));
+        shared.m_header = nullptr;
+        return std::nullopt;
+    }
+
+    return shared;
 }
 
-bool MTLLoader::parseNewMaterial(const std::string& str)
+SharedOBJData::SharedOBJData(SharedOBJData&& other) noexcept
+    : m_segmentName(std::move(other.m_segmentName)),
+      m_data(std::exchange(other.m_data, nullptr)),
+      m_header(std::exchange(other.m_header, nullptr)),
+      m_size(std::exchange(other.m_size, 0))
 {
-    std::stringstream stream{ str };
-    std::string _;
-    std::string name;
+}
 
-    stream >> _ >> name;
+SharedOBJData& SharedOBJData::operator=(SharedOBJData&& other) noexcept
+{
+    if (this == &other) return *this;
+    release();
+    m_segmentName = std::move(other.m_segmentName);
+    m_data        = std::exchange(other.m_data, nullptr);
+    m_header      = std::exchange(other.m_header, nullptr);
+    m_size        = std::exchange(other.m_size, 0);
+    return *this;
+}
 
-    if (stream.fail()) { return false; }
-    if (m_materialNameToIndex.contains(name)) { return false; }
+SharedOBJData::~SharedOBJData()
+{
+    release();
+}
+
+void SharedOBJData::release()
+{
+    if (m_header) {
+        if (m_header->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            shm_unlink(m_segmentName.c_str());
+        }
+        munmap(m_header, sizeof(detail::SharedHeader));
+        m_header = nullptr;
+    }
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+        m_data = nullptr;
+    }
+}
 
-    m_materials.emplace_back(name);
-    m_materialNameToIndex[name] = m_materials.size() - 1;
+template <typename T>
+std::span<const T> SharedOBJData::array(const detail::SharedArray& array) const
+{
+    assert(array.offset + array.count * sizeof(T) <= m_size);
+    return { reinterpret_cast<const T*>(m_data + array.offset), array.count };
+}
 
-    return true;
+std::string_view SharedOBJData::name() const
+{
+    const auto chars = array<char>(m_header->name);
+    return { chars.data(), chars.size() };
 }
 
-std::optional<uint32_t> MTLLoader::parseImage(const std::string& str)
+std::span<const Vec3> SharedOBJData::positions() const
 {
-    std::stringstream stream{ str };
-    std::string _;
-    std::string path;
+    return array<Vec3>(m_header->positions);
+}
 
-    stream >> _ >> path;
+std::span<const Vec3> SharedOBJData::normals() const
+{
+    return array<Vec3>(m_header->normals);
+}
 
-    detail::trim(path);
-    const std::string name = detail::fileNameFromPath(path);
+std::span<const Vec2> SharedOBJData::textureUVs() const
+{
+    return array<Vec2>(m_header->textureUVs);
+}
 
-    if (m_loadedImageToIndex.contains(name)) { return m_loadedImageToIndex[name]; }
+std::span<const Vec3> SharedOBJData::colors() const
+{
+    return array<Vec3>(m_header->colors);
+}
 
-    if (stream.fail()) { return std::nullopt; }
+std::span<const Material> SharedOBJData::materials() const
+{
+    return array<Material>(m_header->materials);
+}
 
-    int x, y, channels;
-    const std::string relativePath = m_workingDirectory + path;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* bytes = stbi_load(relativePath.c_str(), &x, &y, &channels, STBI_default);
-    // TODO: error check here
-    const size_t size = x * y * channels;
+size_t SharedOBJData::numMeshes() const
+{
+    return m_header->meshes.count;
+}
 
-    ImageData data;
-    data.name     = name;
-    data.bytes    = std::vector(bytes, bytes + size);
-    data.height   = x;
-    data.width    = y;
-    data.channels = channels;
+SharedMeshView SharedOBJData::mesh(const size_t index) const
+{
+    const detail::SharedMesh& mesh = array<detail::SharedMesh>(m_header->meshes)[index];
+    return SharedMeshView{
+        .name            = name(mesh.name),
+        .groups          = array<NameID>(mesh.groups),
+        .materialIndex   = mesh.materialIndex == detail::NO_INDEX
+                               ? std::nullopt
+                               : std::optional<uint32_t>{ mesh.materialIndex },
+        .unifiedIndices  = mesh.unifiedIndices != 0,
+        .faceOffsets     = array<uint32_t>(mesh.faceOffsets),
+        .positionIndices = array<uint32_t>(mesh.positionIndices),
+        .normalIndices   = array<uint32_t>(mesh.normalIndices),
+        .uvIndices       = array<uint32_t>(mesh.uvIndices),
+        .colorIndices    = array<uint32_t>(mesh.colorIndices),
+        .smoothingGroups = array<SmoothingRun>(mesh.smoothingGroups),
+    };
+}
 
-    stbi_image_free(bytes);
+size_t SharedOBJData::numImages() const
+{
+    return m_header->images.count;
+}
 
-    m_images.push_back(data);
-    m_loadedImageToIndex[name] = m_images.size() - 1;
+SharedImageView SharedOBJData::image(const size_t index) const
+{
+    const detail::SharedImage& image = array<detail::SharedImage>(m_header->images)[index];
+    return SharedImageView{
+        .name     = name(image.name),
+        .bytes    = array<unsigned char>(image.bytes),
+        .width    = image.width,
+        .height   = image.height,
+        .channels = image.channels,
+    };
+}
 
-    return m_loadedImageToIndex[name];
+std::string_view SharedOBJData::name(const NameID id) const
+{
+    const auto offsets = array<uint64_t>(m_header->nameOffsets);
+    const auto chars   = array<char>(m_header->nameBytes);
+    assert(id + 1 < offsets.size());
+    return { chars.data() + offsets[id], offsets[id + 1] - offsets[id] };
 }
 
-bool MTLLoader::setImageMap(std::optional<uint32_t>& imageMapIndex, const std::string& line,
-                            const Identifier identifier)
+size_t SharedOBJData::size() const
 {
-    const auto result = parseImage(line);
-    if (!result) return false;
-    if (m_materials.empty()) return false;
-    if (imageMapIndex) {
-        m_logger->warn(std::format("Defined two {} image maps in file {} at line {}",
-                                   toString(identifier),
-                                   m_filePath,
-                                   m_line));
+    return m_size;
+}
+#endif
+
+//--------------------------------------------------
+// MARK: MappedFile
+//--------------------------------------------------
+
+namespace detail
+{
+MappedFile::~MappedFile()
+{
+#ifdef SOBJ_POSIX
+    if (m_mapping) munmap(m_mapping, m_size);
+#endif
+}
+
+bool MappedFile::open(const std::string& filePath)
+{
+#ifdef SOBJ_POSIX
+    const int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
     }
-    imageMapIndex = result;
+    m_size = static_cast<size_t>(info.st_size);
+
+    // mmap can not map empty files, those simply stay empty
+    if (m_size > 0) {
+        void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, m_size, MADV_SEQUENTIAL);
+            m_mapping = mapping;
+        }
+    }
+    close(fd);
+    if (m_mapping || m_size == 0) return true;
+#endif
 
-    return true;
+    std::ifstream file{ filePath, std::ios::binary | std::ios::ate };
+    if (!file.is_open()) return false;
+    m_buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    return static_cast<bool>(file);
+}
+
+std::string_view MappedFile::view() const
+{
+#ifdef SOBJ_POSIX
+    if (m_mapping) return { static_cast<const char*>(m_mapping), m_size };
+#endif
+    return { m_buffer.data(), m_buffer.size() };
 }
+} // namespace detail
 
 //--------------------------------------------------
-// MARK: OBJLoader Parsing methods
+// MARK: PLYLoader Parsing methods
 //--------------------------------------------------
-bool OBJLoader::load(const std::string& filePath)
+
+namespace detail
+{
+constexpr size_t PLY_MAX_FACE_VERTICES = 256;
+// never a valid position index, marks indices that are no integer
+constexpr uint32_t PLY_INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+/// @brief List counts and indices are read as doubles, anything but a non-negative integer
+/// that fits 32 bits is rejected.
+inline std::optional<uint32_t> plyInteger(const double value)
+{
+    if (!(value >= 0.0) || value > static_cast<double>(PLY_INVALID_INDEX) ||
+        value != std::floor(value)) {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>(value);
+}
+
+template <typename T> T readBinary(const char* ptr, const bool swap)
+{
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    if (!swap) return value;
+
+    if constexpr (sizeof(T) == 1) {
+        return value;
+    } else {
+        using Bits = std::conditional_t<sizeof(T) == 2,
+                                        uint16_t,
+                                        std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>;
+        return std::bit_cast<T>(std::byteswap(std::bit_cast<Bits>(value)));
+    }
+}
+
+template <typename Fn> void withNumbers(std::string_view str, Fn&& fn)
+{
+    for (auto token = nextToken(str); !token.empty(); token = nextToken(str)) {
+        double value      = 0.0;
+        const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (result.ec != std::errc{}) value = std::numeric_limits<double>::quiet_NaN();
+        fn(value);
+    }
+}
+} // namespace detail
+
+bool PLYLoader::load(const std::string& filePath)
 {
+    detail::TraceScope trace{ "PLYLoader::load" };
+    detail::LoadRecord record{};
     reset();
+    if (m_reclaimer) {
+        m_reclaimer->reuse(m_positions);
+        m_reclaimer->reuse(m_normals);
+        m_reclaimer->reuse(m_textureUVs);
+        m_reclaimer->reuse(m_colors);
+    }
 
-    detail::trim(m_filePath);
     m_filePath = filePath;
+    detail::trim(m_filePath);
 
-    std::filesystem::path objPath = m_filePath;
-    m_workingDirectory            = objPath.parent_path().string() + "/";
-
-    if (!m_filePath.ends_with(".obj")) {
-        m_logger->error(std::format("The file {} does not have the .obj extension", m_filePath));
+    if (!m_filePath.ends_with(".ply")) {
+        m_logger->error(std::format("The file {} does not have the .ply extension", m_filePath));
         return false;
     }
 
-    // open file, TODO(Error handling here?)
-    std::ifstream file;
-    file.open(filePath);
+    detail::TraceScope traceOpen{ "PLYLoader::open" };
+    detail::MappedFile file;
+    if (!file.open(m_filePath)) {
+        m_logger->error(std::format("Could not open file {}", m_filePath));
+        return false;
+    }
+    traceOpen.end();
 
-    if (!file.is_open()) return false;
+    std::string_view data = file.view();
+    record.bytes          = data.size();
+    if (!parseHeader(data)) return false;
 
-    std::string line;
-    while (std::getline(file, line)) {
-        detail::trim(line);
+    m_meshes.push_back({});
+    m_meshes.back().name = m_names.intern(detail::DEFAULT_MESH_NAME);
 
-        switch (identifier(line)) {
-        case Identifier::POSITION: {
-            const auto result = m_mathParser.parseVec3(line);
-            if (!result) {
-                m_logger->error(std::format(
-                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
-                return false;
-            }
-            m_positions.push_back(*result);
-            break;
-        }
-        case Identifier::NORMAL: {
-            const auto result = m_mathParser.parseVec3(line);
-            if (!result) {
-                m_logger->error(std::format(
-                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
-                return false;
-            }
-            m_normals.push_back(*result);
-            break;
-        }
-        case Identifier::UV: {
-            const auto result = m_mathParser.parseVec2(line);
-            if (!result) {
-                m_logger->error(std::format(
-                    "An error occurred when parsing {} at line {}", m_filePath, m_line));
-                return false;
-            }
-            m_textureUVs.push_back(*result);
-            break;
-        }
-        case Identifier::FACE: {
-            const auto result = parseFace(line);
-            if (!result) return false;
-            if (m_config.triangulate) {
-                pushFaces(triangulate(*result));
-            } else {
-                pushFace(*result);
-            }
-            break;
-        }
-        case Identifier::SMOOTH_SHADING: {
-            parseSmoothShading(line);
-            break;
-        }
-        case Identifier::NAMED_OBJECT:
-        case Identifier::GROUP: {
-            parseGroup(line);
-            break;
-        }
-        case Identifier::MATERIAL_LIB: {
-            const auto result = parseMaterialFilePath(line);
-            if (!result) return false;
-            m_mtlLoader.loadMaterialFile(m_workingDirectory + *result); // look in this dir
-            m_materials           = m_mtlLoader.stealMaterials();
-            m_images              = m_mtlLoader.stealImages();
-            m_materialNameToIndex = m_mtlLoader.materialNameToIndex();
-            break;
-        }
-        case Identifier::USE_MATERIAL: {
-            parseUseMaterial(line);
-            break;
-        }
-        case Identifier::BLANK:
-        case Identifier::COMMENT:
-            break;
-        case Identifier::UNKNOWN:
-            m_logger->warn(std::format(
-                "Encountered unknown line identifier in file {} at line {}.", m_filePath, m_line));
-            break;
-        }
+    const bool result = m_format == Format::ASCII ? parseASCII(data) : parseBinary(data);
+    if (!result) return false;
 
-        m_line++;
+    if (m_positions.empty()) {
+        m_logger->error(std::format(".ply file {} must include at least 1 position", m_filePath));
+        return false;
     }
+    if (!finishFaces()) return false;
 
-    file.close();
+    m_logger->info(std::format("Successfully parsed and loaded data from {}", m_filePath));
 
-    if (m_positions.empty()) {
-        m_logger->error(std::format(".obj file {} must include at least 1 position", m_filePath));
+    shrink();
+
+    record.faces   = m_meshes.back().faces.size();
+    record.success = true;
+
+    return true;
+}
+
+bool PLYLoader::parseHeader(std::string_view& data)
+{
+    std::string_view rest = data;
+    if (detail::nextLine(rest) != "ply") {
+        m_logger->error(std::format("The file {} does not start with ply", m_filePath));
         return false;
     }
 
-    m_logger->info(std::format("Successfully parsed and loaded data from {}", m_filePath));
+    for (;;) {
+        if (rest.empty()) {
+            m_logger->error(std::format("The header of {} is missing end_header", m_filePath));
+            return false;
+        }
+
+        std::string_view line          = detail::nextLine(rest);
+        const std::string_view keyword = detail::nextToken(line);
+
+        if (keyword == "end_header") break;
+        if (keyword == "comment" || keyword == "obj_info" || keyword.empty()) continue;
+
+        if (keyword == "format") {
+            const std::string_view format = detail::nextToken(line);
+            if (format == "ascii") m_format = Format::ASCII;
+            else if (format == "binary_little_endian") m_format = Format::BINARY_LITTLE_ENDIAN;
+            else if (format == "binary_big_endian") m_format = Format::BINARY_BIG_ENDIAN;
+            else {
+                m_logger->error(std::format("Unknown ply format {} in {}", format, m_filePath));
+                return false;
+            }
+        } else if (keyword == "element") {
+            Element element{};
+            element.name               = detail::nextToken(line);
+            const std::string_view num = detail::nextToken(line);
+            const auto result = std::from_chars(num.data(), num.data() + num.size(), element.count);
+            if (element.name.empty() || result.ec != std::errc{}) {
+                m_logger->error(std::format("Invalid element declaration in {}", m_filePath));
+                return false;
+            }
+            m_elements.push_back(std::move(element));
+        } else if (keyword == "property") {
+            if (m_elements.empty()) {
+                m_logger->error(
+                    std::format("Property declared before any element in {}", m_filePath));
+                return false;
+            }
 
-    shrink();
+            Property property{};
+            std::string_view type = detail::nextToken(line);
+            if (type == "list") {
+                property.isList        = true;
+                const auto countType   = propertyType(detail::nextToken(line));
+                type                   = detail::nextToken(line);
+                if (!countType) {
+                    m_logger->error(std::format("Invalid list count type in {}", m_filePath));
+                    return false;
+                }
+                property.countType = *countType;
+            }
+            const auto valueType = propertyType(type);
+            property.name        = detail::nextToken(line);
+            if (!valueType || property.name.empty()) {
+                m_logger->error(std::format("Invalid property declaration in {}", m_filePath));
+                return false;
+            }
+            property.type = *valueType;
+            m_elements.back().properties.push_back(std::move(property));
+        } else {
+            m_logger->warn(std::format("Unknown header keyword {} in {}", keyword, m_filePath));
+        }
+    }
 
+    data = rest;
     return true;
 }
 
-std::optional<Vec3> MathParser::parseVec3(const std::string& str) const
+bool PLYLoader::parseBinary(const std::string_view data)
 {
-    // TODO: handle too many args? what about comments inline
-    std::stringstream stream{ str };
-    float x, y, z;
-    std::string _;
-    stream >> _ >> x >> y >> z;
-    if (stream.fail()) { return std::nullopt; }
+    const bool bigEndian = m_format == Format::BINARY_BIG_ENDIAN;
+    const bool swap      = bigEndian != (std::endian::native == std::endian::big);
+
+    size_t offset = 0;
+    for (const auto& element : m_elements) {
+        Rows rows{};
+        if (!findRows(element, data, offset, swap, rows)) {
+            m_logger->error(
+                std::format("The {} element of {} is truncated", element.name, m_filePath));
+            return false;
+        }
 
-    return { { x, y, z } };
+        if (element.name == "vertex") {
+            readVertices(element, data, rows, swap);
+            transformVertices();
+        } else if (element.name == "face") {
+            if (!readFaces(element, data, rows, swap)) return false;
+        }
+        offset = rows.end;
+    }
+
+    return true;
 }
 
-std::optional<Vec2> MathParser::parseVec2(const std::string& str) const
+bool PLYLoader::findRows(const Element& element, const std::string_view data, const size_t offset,
+                         const bool swap, Rows& rows) const
 {
-    // TODO: handle too many args? what about comments inline
-    std::stringstream stream{ str };
-    float x, y;
-    std::string _;
-    stream >> _ >> x >> y;
-    if (stream.fail()) { return std::nullopt; }
+    rows.begin = offset;
 
-    return { { x, y } };
-}
+    const bool fixed = std::ranges::none_of(element.properties, &Property::isList);
+    if (fixed) {
+        for (const auto& property : element.properties) {
+            rows.stride += typeSize(property.type);
+        }
+        rows.end = offset + rows.stride * element.count;
+        return rows.stride == 0 || (data.size() >= offset &&
+                                    (data.size() - offset) / rows.stride >= element.count);
+    }
 
-std::optional<float> MathParser::parseFloat(const std::string& str) const
-{
-    // TODO: handle too many args? what about comments inline
-    std::stringstream stream{ str };
-    float x;
-    std::string _;
-    stream >> _ >> x;
-    if (stream.fail()) { return std::nullopt; }
+    // rows with lists have to be walked to find where each one starts
+    rows.starts.resize(element.count);
+    size_t position = offset;
+    for (size_t row = 0; row < element.count; row++) {
+        rows.starts[row] = position;
+        for (const auto& property : element.properties) {
+            if (!property.isList) {
+                position += typeSize(property.type);
+                continue;
+            }
+            const size_t countSize = typeSize(property.countType);
+            if (position + countSize > data.size()) return false;
+            const auto count =
+                detail::plyInteger(readValue(data.data() + position, property.countType, swap));
+            if (!count) return false;
+            position += countSize + size_t{ *count } * typeSize(property.type);
+        }
+        if (position > data.size()) return false;
+    }
+    rows.end = position;
 
-    return { x };
+    return true;
 }
 
-std::optional<Face> OBJLoader::parseFace(const std::string& str)
+void PLYLoader::readVertices(const Element& element, const std::string_view data, const Rows& rows,
+                             const bool swap)
 {
-    std::stringstream stream{ str };
-    Face face;
-    std::string _;
-    stream >> _;
+    detail::TraceScope trace{ "PLYLoader::readVertices" };
+    // offset of every property inside a row, only meaningful for rows without lists
+    std::unordered_map<std::string_view, size_t> indexOf{};
+    std::vector<size_t> offsets{};
+    size_t offset = 0;
+    for (size_t i = 0; i < element.properties.size(); i++) {
+        indexOf.emplace(element.properties[i].name, i);
+        offsets.push_back(offset);
+        offset += typeSize(element.properties[i].type);
+    }
 
-    // v//vn syntax
-    if (str.find("//") != std::string::npos) {
-        int32_t v, vn;
-        char slash1, slash2;
+    const auto pointer = [&](const size_t row, const size_t property) -> const char* {
+        const char* ptr = data.data() + rows.start(row);
+        if (rows.stride) return ptr + offsets[property];
+        for (size_t i = 0; i < property; i++) {
+            const Property& p = element.properties[i];
+            if (!p.isList) {
+                ptr += typeSize(p.type);
+                continue;
+            }
+            const auto count = static_cast<size_t>(readValue(ptr, p.countType, swap));
+            ptr += typeSize(p.countType) + count * typeSize(p.type);
+        }
+        return ptr;
+    };
 
-        while (stream >> v >> slash1 >> slash2 >> vn) {
-            if (slash1 != detail::DELIMITER || slash2 != detail::DELIMITER) {
-                m_logger->error(
-                    std::format("Invalid syntax encountered in file {} at line {} ({} or "
-                                "{} is not \\)",
-                                m_filePath,
-                                m_line,
-                                slash1,
-                                slash2));
+    const auto find = [&](const std::initializer_list<std::string_view> names) {
+        std::optional<size_t> result = std::nullopt;
+        for (const auto name : names) {
+            if (const auto it = indexOf.find(name); it != indexOf.end()) {
+                if (!element.properties[it->second].isList) result = it->second;
+                break;
             }
-            face.positionIndices.push_back(calculateIndex(v, IndexType::POSITION));
-            face.normalIndices.push_back(calculateIndex(vn, IndexType::NORMAL));
         }
+        return result;
+    };
 
-        return { face };
-    }
+    const auto scale = [&](const size_t property) {
+        return colorScale(element.properties[property].type);
+    };
 
-    if (str.find("/") != std::string::npos) {
-        int32_t v, vt;
-        char slash1;
-        stream >> v >> slash1 >> vt;
+    const auto readVec3 = [&](const std::array<size_t, 3> properties, std::vector<Vec3>& out) {
+        out.resize(element.count);
 
-        // v/vt/vn syntax
-        if (stream.peek() == detail::DELIMITER) {
-            char slash2;
-            int32_t vn;
-            stream >> slash2 >> vn;
-            do {
-                if (slash1 != detail::DELIMITER || slash2 != detail::DELIMITER) {
-                    m_logger->error(
-                        std::format("Invalid syntax encountered in file {} at line {} ({} "
-                                    "or {} is not \\)",
-                                    m_filePath,
-                                    m_line,
-                                    slash1,
-                                    slash2));
-                }
-                face.positionIndices.push_back(calculateIndex(v, IndexType::POSITION));
-                face.uvIndices.push_back(calculateIndex(vt, IndexType::UV));
-                face.normalIndices.push_back(calculateIndex(vn, IndexType::NORMAL));
-            } while (stream >> v >> slash1 >> vt >> slash2 >> vn);
+        const bool floats = std::ranges::all_of(properties, [&](const size_t p) {
+            return element.properties[p].type == PropertyType::FLOAT32;
+        });
+        const bool packed = rows.stride && floats &&
+                            offsets[properties[1]] == offsets[properties[0]] + 4 &&
+                            offsets[properties[2]] == offsets[properties[0]] + 8;
 
-            return { face };
+        // the vertex element is nothing but this vector
+        if (packed && !swap && rows.stride == sizeof(Vec3)) {
+            std::memcpy(out.data(), data.data() + rows.begin, element.count * sizeof(Vec3));
+            return;
         }
 
-        // v/vt syntax
-        do {
-            if (slash1 != detail::DELIMITER) {
-                m_logger->error(
-                    std::format("Invalid syntax encountered in file {} at line {} ({} is "
-                                "not \\)",
-                                m_filePath,
-                                m_line,
-                                slash1));
+        const double scales[] = { scale(properties[0]),
+                                  scale(properties[1]),
+                                  scale(properties[2]) };
+        executor()->parallelFor(element.count, [&](const size_t row) {
+            if (packed && !swap) {
+                std::memcpy(&out[row], pointer(row, properties[0]), sizeof(Vec3));
+                return;
             }
-            face.positionIndices.push_back(calculateIndex(v, IndexType::POSITION));
-            face.uvIndices.push_back(calculateIndex(vt, IndexType::UV));
-        } while (stream >> v >> slash1 >> vt);
+            float values[3];
+            for (size_t i = 0; i < 3; i++) {
+                const Property& property = element.properties[properties[i]];
+                values[i]                = static_cast<float>(
+                    readValue(pointer(row, properties[i]), property.type, swap) *
+                    scales[i]);
+            }
+            out[row] = { values[0], values[1], values[2] };
+        });
+    };
 
-        return { face };
+    const auto x  = find({ "x" });
+    const auto y  = find({ "y" });
+    const auto z  = find({ "z" });
+    const auto nx = find({ "nx" });
+    const auto ny = find({ "ny" });
+    const auto nz = find({ "nz" });
+    const auto r  = find({ "red", "r" });
+    const auto g  = find({ "green", "g" });
+    const auto b  = find({ "blue", "b" });
+    const auto u  = find({ "u", "s", "texture_u", "texture_s" });
+    const auto v  = find({ "v", "t", "texture_v", "texture_t" });
+
+    if (x && y && z) readVec3({ *x, *y, *z }, m_positions);
+    else m_logger->warn(std::format("The vertices of {} have no x, y and z", m_filePath));
+    if (nx && ny && nz) readVec3({ *nx, *ny, *nz }, m_normals);
+    if (r && g && b) readVec3({ *r, *g, *b }, m_colors);
+    if (u && v) {
+        m_textureUVs.resize(element.count);
+        executor()->parallelFor(element.count, [&](const size_t row) {
+            m_textureUVs[row] = {
+                static_cast<float>(
+                    readValue(pointer(row, *u), element.properties[*u].type, swap)),
+                static_cast<float>(
+                    readValue(pointer(row, *v), element.properties[*v].type, swap)),
+            };
+        });
     }
+}
 
-    // v1 v2 v3 syntax
-    int32_t v;
-    while (stream >> v) {
-        face.positionIndices.push_back(calculateIndex(v, IndexType::POSITION));
+bool PLYLoader::readFaces(const Element& element, const std::string_view data, const Rows& rows,
+                          const bool swap)
+{
+    detail::TraceScope trace{ "PLYLoader::readFaces" };
+    const auto list = std::ranges::find_if(element.properties, [](const Property& property) {
+        return property.isList &&
+               (property.name == "vertex_indices" || property.name == "vertex_index");
+    });
+    if (list == element.properties.end()) {
+        m_logger->warn(std::format("The faces of {} have no vertex_indices", m_filePath));
+        return true;
     }
+    const auto listIndex = static_cast<size_t>(list - element.properties.begin());
+
+    // findRows already checked every count
+    std::vector<Face> faces(element.count);
+    std::atomic<size_t> truncated  = 0;
+    std::atomic<size_t> degenerate = 0;
+    executor()->parallelFor(element.count, [&](const size_t row) {
+        const char* ptr = data.data() + rows.start(row);
+        for (size_t i = 0; i < listIndex; i++) {
+            const Property& p = element.properties[i];
+            if (!p.isList) {
+                ptr += typeSize(p.type);
+                continue;
+            }
+            const size_t count =
+                detail::plyInteger(readValue(ptr, p.countType, swap)).value_or(0);
+            ptr += typeSize(p.countType) + count * typeSize(p.type);
+        }
+
+        size_t count = detail::plyInteger(readValue(ptr, list->countType, swap)).value_or(0);
+        ptr += typeSize(list->countType);
+        if (count < 3) {
+            degenerate++;
+            return;
+        }
+        if (count > detail::PLY_MAX_FACE_VERTICES) {
+            count = detail::PLY_MAX_FACE_VERTICES;
+            truncated++;
+        }
+
+        uint32_t indices[detail::PLY_MAX_FACE_VERTICES];
+        for (size_t i = 0; i < count; i++) {
+            indices[i] = detail::plyInteger(readValue(ptr, list->type, swap))
+                             .value_or(detail::PLY_INVALID_INDEX);
+            ptr += typeSize(list->type);
+        }
+        faces[row] = makeFace({ indices, count });
+    });
 
-    return { face };
+    warnSkippedFaces(truncated, degenerate);
+    if (degenerate) std::erase_if(faces, [](const Face& face) { return face.numVertices() == 0; });
+    pushFaces(std::move(faces));
+    return true;
 }
 
-void OBJLoader::parseSmoothShading(const std::string& str)
+bool PLYLoader::parseASCII(std::string_view data)
 {
-    std::stringstream stream{ str };
-    std::string _;
-    stream >> _;
+    detail::TraceScope trace{ "PLYLoader::parseASCII" };
+    for (const auto& element : m_elements) {
+        const bool vertex = element.name == "vertex";
+        const bool face   = element.name == "face";
+
+        std::unordered_map<std::string_view, size_t> indexOf{};
+        for (size_t i = 0; i < element.properties.size(); i++) {
+            indexOf.emplace(element.properties[i].name, i);
+        }
+        const auto find = [&](const std::initializer_list<std::string_view> names) {
+            std::optional<size_t> result = std::nullopt;
+            for (const auto name : names) {
+                if (const auto it = indexOf.find(name); it != indexOf.end()) {
+                    result = it->second;
+                    break;
+                }
+            }
+            return result;
+        };
+        const auto x  = find({ "x" });
+        const auto y  = find({ "y" });
+        const auto z  = find({ "z" });
+        const auto nx = find({ "nx" });
+        const auto ny = find({ "ny" });
+        const auto nz = find({ "nz" });
+        const auto r  = find({ "red", "r" });
+        const auto g  = find({ "green", "g" });
+        const auto b  = find({ "blue", "b" });
+        const auto u  = find({ "u", "s", "texture_u", "texture_s" });
+        const auto v  = find({ "v", "t", "texture_v", "texture_t" });
+        const auto indices = find({ "vertex_indices", "vertex_index" });
+        const auto scale   = [&](const std::optional<size_t> property) {
+            return property ? colorScale(element.properties[*property].type) : 1.0;
+        };
+        const double scales[] = { scale(r), scale(g), scale(b) };
+
+        std::vector<Face> faces{};
+        size_t truncated  = 0;
+        size_t degenerate = 0;
+        std::vector<double> values{};
+        std::vector<uint32_t> faceIndices{};
+        // property index to value index, lists take up their count plus their entries
+        std::vector<size_t> valueOf(element.properties.size());
+        for (size_t row = 0; row < element.count; row++) {
+            if (data.empty()) {
+                m_logger->error(
+                    std::format("The {} element of {} is truncated", element.name, m_filePath));
+                return false;
+            }
+            values.clear();
+            detail::withNumbers(detail::nextLine(data),
+                                [&](const double value) { values.push_back(value); });
+
+            // every property needs its value, lists their count and all of their entries
+            size_t valueIndex = 0;
+            bool malformed    = false;
+            for (size_t i = 0; i < element.properties.size() && !malformed; i++) {
+                valueOf[i] = valueIndex;
+                if (valueIndex >= values.size()) {
+                    malformed = true;
+                } else if (element.properties[i].isList) {
+                    const auto count = detail::plyInteger(values[valueIndex]);
+                    if (count) valueIndex += 1 + size_t{ *count };
+                    else malformed = true;
+                } else {
+                    valueIndex++;
+                }
+            }
+            if (malformed || valueIndex > values.size()) {
+                m_logger->error(std::format(
+                    "The {} element of {} has a malformed row", element.name, m_filePath));
+                return false;
+            }
 
-    // word syntax
-    if (stream.peek() == 'o') {
-        std::string toggle{};
-        stream >> toggle;
-        if (toggle == detail::ON) {
-            if (m_smoothShadingEnabled) return;
-            makeGroupAnonym();
-            m_smoothShadingEnabled = true;
-        } else if (toggle == detail::OFF) {
-            if (!m_smoothShadingEnabled) return;
-            makeGroupAnonym();
-            m_smoothShadingEnabled = false;
-        } else {
-            m_logger->warn(std::format("Could not parse file {} line {} due to unknown word {}",
-                                       m_filePath,
-                                       m_line,
-                                       toggle));
+            const auto at = [&](const size_t property, const double scale = 1.0) {
+                return static_cast<float>(values[valueOf[property]] * scale);
+            };
+            if (vertex) {
+                if (x && y && z) m_positions.push_back({ at(*x), at(*y), at(*z) });
+                if (nx && ny && nz) m_normals.push_back({ at(*nx), at(*ny), at(*nz) });
+                if (r && g && b) {
+                    m_colors.push_back(
+                        { at(*r, scales[0]), at(*g, scales[1]), at(*b, scales[2]) });
+                }
+                if (u && v) m_textureUVs.push_back({ at(*u), at(*v) });
+            } else if (face && indices) {
+                const size_t listStart = valueOf[*indices];
+                size_t count           = static_cast<size_t>(values[listStart]);
+                if (count < 3) {
+                    degenerate++;
+                    continue;
+                }
+                // the same limit as binary files
+                if (count > detail::PLY_MAX_FACE_VERTICES) {
+                    count = detail::PLY_MAX_FACE_VERTICES;
+                    truncated++;
+                }
+                faceIndices.clear();
+                for (size_t i = 0; i < count; i++) {
+                    faceIndices.push_back(detail::plyInteger(values[listStart + 1 + i])
+                                              .value_or(detail::PLY_INVALID_INDEX));
+                }
+                faces.push_back(makeFace(faceIndices));
+            }
         }
-    }
 
-    // number syntax
-    int toggle;
-    stream >> toggle;
-    if (toggle) {
-        if (m_smoothShadingEnabled) return;
-        makeGroupAnonym();
-        m_smoothShadingEnabled = true;
-    } else {
-        if (!m_smoothShadingEnabled) return;
-        makeGroupAnonym();
-        m_smoothShadingEnabled = false;
+        warnSkippedFaces(truncated, degenerate);
+        if (face) pushFaces(std::move(faces));
+        if (vertex) transformVertices();
     }
+
+    return true;
 }
 
-void OBJLoader::parseGroup(const std::string& str)
+void PLYLoader::transformVertices()
 {
-    std::stringstream stream{ str };
-    std::string _;
-    std::string line{};
-    stream >> _;
-    std::getline(stream, line);
-    makeGroup(line);
+    const auto& transform = m_config.transform;
+    if (!transform.matrix && !transform.flipUVs) return;
+
+    detail::TraceScope trace{ "PLYLoader::transformVertices" };
+    const size_t count = std::max({ m_positions.size(), m_normals.size(), m_textureUVs.size() });
+    executor()->parallelFor(count, [&](const size_t i) {
+        if (i < m_positions.size()) transform.apply(m_positions[i]);
+        if (i < m_normals.size()) transform.applyNormal(m_normals[i]);
+        if (i < m_textureUVs.size()) transform.apply(m_textureUVs[i]);
+    });
 }
 
-std::optional<std::string> OBJLoader::parseMaterialFilePath(const std::string& str) const
+//--------------------------------------------------
+// MARK: PLYLoader Helper Methods
+//--------------------------------------------------
+
+std::optional<PLYLoader::PropertyType> PLYLoader::propertyType(const std::string_view str) const
 {
-    std::stringstream stream{ str };
-    std::string _;
-    std::string path{};
-    stream >> _;
-    std::getline(stream, path);
-    detail::trim(path);
-    return { path };
+    if (str == "char" || str == "int8") return PropertyType::INT8;
+    if (str == "uchar" || str == "uint8") return PropertyType::UINT8;
+    if (str == "short" || str == "int16") return PropertyType::INT16;
+    if (str == "ushort" || str == "uint16") return PropertyType::UINT16;
+    if (str == "int" || str == "int32") return PropertyType::INT32;
+    if (str == "uint" || str == "uint32") return PropertyType::UINT32;
+    if (str == "float" || str == "float32") return PropertyType::FLOAT32;
+    if (str == "double" || str == "float64") return PropertyType::FLOAT64;
+    return std::nullopt;
 }
 
-bool OBJLoader::parseUseMaterial(const std::string& str)
+size_t PLYLoader::typeSize(const PropertyType type)
 {
-    if (m_meshes.empty()) { return false; }
-
-    std::stringstream stream{ str };
-    std::string _;
-    std::string name;
-    stream >> _;
-    std::getline(stream, name);
-    detail::trim(name);
-
-    if (stream.fail()) { return false; }
-
-    if (!m_materialNameToIndex.contains(name)) { return false; }
-
-    m_meshes.back().materialIndex = m_materialNameToIndex[name];
-
-    return true;
+    switch (type) {
+    case PropertyType::INT8:
+    case PropertyType::UINT8:
+        return 1;
+    case PropertyType::INT16:
+    case PropertyType::UINT16:
+        return 2;
+    case PropertyType::INT32:
+    case PropertyType::UINT32:
+    case PropertyType::FLOAT32:
+        return 4;
+    case PropertyType::FLOAT64:
+        return 8;
+    }
+    // can never happen
+    assert(false);
+    return 0;
 }
 
-//--------------------------------------------------
-// MARK: MTLLoader Helper Methods
-//--------------------------------------------------
-
-std::string MTLLoader::toString(const Identifier identifier) const
+double PLYLoader::colorScale(const PropertyType type)
 {
-    switch (identifier) {
-    case Identifier::NEW_MATERIAL:
-        return "newmtl";
-    case Identifier::AMBIENT_MAP:
-        return "map_Ka";
-    case Identifier::DIFFUSE_MAP:
-        return "map_Kd";
-    case Identifier::SPECULAR_MAP:
-        return "map_Ks";
-    case Identifier::ROUGHNESS_MAP:
-        return "map_Ns";
-    case Identifier::ALPHA_MAP:
-        return "map_d";
-    case Identifier::AMBIENT:
-        return "Ka";
-    case Identifier::DIFFUSE:
-        return "Kd";
-    case Identifier::SPECULAR:
-        return "Ks";
-    case Identifier::ROUGHNESS:
-        return "Ns";
-    case Identifier::ALPHA:
-        return "d";
-    case Identifier::COMMENT:
-        return "#";
-    case Identifier::BLANK:
-        return "";
-    case Identifier::UNKNOWN:
-        return "unknown";
+    switch (type) {
+    case PropertyType::UINT8:
+        return 1.0 / 255.0;
+    case PropertyType::UINT16:
+        return 1.0 / 65535.0;
     default:
-        return "invalid";
+        return 1.0;
     }
 }
 
-MTLLoader::Identifier MTLLoader::identifier(const std::string_view str) const
+void PLYLoader::warnSkippedFaces(const size_t truncated, const size_t degenerate) const
 {
-    if (str.starts_with("newmtl ")) return Identifier::NEW_MATERIAL;
-
-    if (str.starts_with("map_Ka ")) return Identifier::AMBIENT_MAP;
-    if (str.starts_with("map_Kd ")) return Identifier::DIFFUSE_MAP;
-    if (str.starts_with("map_Ks ")) return Identifier::SPECULAR_MAP;
-    if (str.starts_with("map_Ns ")) return Identifier::ROUGHNESS_MAP;
-    if (str.starts_with("map_d ")) return Identifier::ALPHA_MAP;
-
-    if (str.starts_with("Ka ")) return Identifier::AMBIENT;
-    if (str.starts_with("Kd ")) return Identifier::DIFFUSE;
-    if (str.starts_with("Ks ")) return Identifier::SPECULAR;
-    if (str.starts_with("Ns ")) return Identifier::ROUGHNESS;
-    if (str.starts_with("d ")) return Identifier::ALPHA;
-
-    if (str.starts_with("# ")) return Identifier::COMMENT;
-    if (str.empty()) return Identifier::BLANK;
+    if (truncated) {
+        m_logger->warn(std::format("{} faces of {} have more than {} vertices, only their first "
+                                   "{} are kept",
+                                   truncated,
+                                   m_filePath,
+                                   detail::PLY_MAX_FACE_VERTICES,
+                                   detail::PLY_MAX_FACE_VERTICES));
+    }
+    if (degenerate) {
+        m_logger->warn(std::format(
+            "{} faces of {} have fewer than 3 vertices and are skipped", degenerate, m_filePath));
+    }
+}
 
-    return Identifier::UNKNOWN;
+double PLYLoader::readValue(const char* ptr, const PropertyType type, const bool swap)
+{
+    switch (type) {
+    case PropertyType::INT8:
+        return detail::readBinary<int8_t>(ptr, swap);
+    case PropertyType::UINT8:
+        return detail::readBinary<uint8_t>(ptr, swap);
+    case PropertyType::INT16:
+        return detail::readBinary<int16_t>(ptr, swap);
+    case PropertyType::UINT16:
+        return detail::readBinary<uint16_t>(ptr, swap);
+    case PropertyType::INT32:
+        return detail::readBinary<int32_t>(ptr, swap);
+    case PropertyType::UINT32:
+        return detail::readBinary<uint32_t>(ptr, swap);
+    case PropertyType::FLOAT32:
+        return detail::readBinary<float>(ptr, swap);
+    case PropertyType::FLOAT64:
+        return detail::readBinary<double>(ptr, swap);
+    }
+    // can never happen
+    assert(false);
+    return 0.0;
 }
 
-std::vector<Material> MTLLoader::stealMaterials()
+Face PLYLoader::makeFace(const std::span<const uint32_t> indices) const
 {
-    return std::move(m_materials);
+    Face face{};
+    face.positionIndices.assign(indices.begin(), indices.end());
+    return face;
 }
 
-std::vector<ImageData> MTLLoader::stealImages()
+bool PLYLoader::finishFaces()
 {
-    return std::move(m_images);
+    std::vector<Face>& faces = m_meshes.back().faces;
+    const size_t count       = m_positions.size();
+    std::atomic<bool> valid  = true;
+    executor()->parallelFor(faces.size(), [&](const size_t i) {
+        Face& face = faces[i];
+        for (const uint32_t index : face.positionIndices) {
+            if (index >= count) valid = false;
+        }
+        if (!m_normals.empty()) face.normalIndices = face.positionIndices;
+        if (!m_textureUVs.empty()) face.uvIndices = face.positionIndices;
+        if (!m_colors.empty()) face.colorIndices = face.positionIndices;
+    });
+
+    if (!valid) {
+        m_logger->error(std::format("Invalid face encountered in {}", m_filePath));
+        return false;
+    }
+    return true;
 }
 
-std::unordered_map<std::string, uint32_t> MTLLoader::materialNameToIndex()
+void PLYLoader::pushFaces(std::vector<Face> faces)
 {
-    return m_materialNameToIndex;
+    Mesh& mesh = m_meshes.back();
+    if (!m_config.triangulate) {
+        std::ranges::move(faces, std::back_inserter(mesh.faces));
+        return;
+    }
+
+    // fan triangulation, the same split OBJLoader uses for quads
+    for (auto& face : faces) {
+        if (face.numVertices() == 3) {
+            mesh.faces.push_back(std::move(face));
+            continue;
+        }
+        for (size_t i = 1; i + 1 < face.numVertices(); i++) {
+            const uint32_t corners[] = { face.positionIndices[0],
+                                         face.positionIndices[i],
+                                         face.positionIndices[i + 1] };
+            mesh.faces.push_back(makeFace(corners));
+        }
+    }
 }
 
-void MTLLoader::reset()
+std::shared_ptr<Executor> PLYLoader::executor() const
 {
-    m_materials.clear();
-    m_filePath.clear();
-    m_line = 0;
+    return m_executor ? m_executor : defaultExecutor();
 }
 
-bool MTLLoader::materialExists() const
+void PLYLoader::shrink()
 {
-    if (m_materials.empty()) {
-        m_logger->error(
-            std::format("Attempting to load images before declaring a material in {} at line {}",
-                        m_filePath,
-                        m_line));
-        return false;
+    // pooled buffers would just be copied into smaller ones
+    if (!m_reclaimer) {
+        m_positions.shrink_to_fit();
+        m_normals.shrink_to_fit();
+        m_textureUVs.shrink_to_fit();
+        m_colors.shrink_to_fit();
+    }
+    for (auto& mesh : m_meshes) {
+        mesh.faces.shrink_to_fit();
     }
-
-    return true;
 }
 
-//--------------------------------------------------
-// MARK: OBJLoader Helper Methods
-//--------------------------------------------------
-
-OBJData OBJLoader::steal()
+OBJData PLYLoader::steal()
 {
     OBJData data;
     data.name       = detail::fileNameFromPath(m_filePath);
@@ -969,203 +5984,196 @@ OBJData OBJLoader::steal()
     data.textureUVs = std::move(m_textureUVs);
     data.colors     = std::move(m_colors);
     data.meshes     = std::move(m_meshes);
-    data.materials  = std::move(m_materials);
-    data.images     = std::move(m_images);
+    data.names      = std::move(m_names);
 
     reset();
 
     return data;
 }
 
-OBJData OBJLoader::share() const
-{
-    OBJData data;
-    data.name       = detail::fileNameFromPath(m_filePath);
-    data.positions  = m_positions;
-    data.normals    = m_normals;
-    data.textureUVs = m_textureUVs;
-    data.colors     = m_colors;
-    data.meshes     = m_meshes;
-    data.materials  = m_materials;
-    data.images     = m_images;
-
-    return data;
-}
-
-void OBJLoader::reset()
+void PLYLoader::reset()
 {
-    m_line = 0;
-    m_currentMeshName.clear();
+    m_format = Format::ASCII;
+    m_elements.clear();
     m_filePath.clear();
     m_positions.clear();
     m_normals.clear();
     m_textureUVs.clear();
     m_colors.clear();
     m_meshes.clear();
+    m_names.clear();
     m_logger->clear();
 }
 
-OBJLoader::Identifier OBJLoader::identifier(const std::string_view str) const
+void PLYLoader::setShouldTriangulate(const bool b)
 {
-    if (str.starts_with("v ")) return Identifier::POSITION;
-    if (str.starts_with("vn ")) return Identifier::NORMAL;
-    if (str.starts_with("vt ")) return Identifier::UV;
-    if (str.starts_with("f ")) return Identifier::FACE;
-    if (str.starts_with("g ")) return Identifier::GROUP;
-    if (str.starts_with("o ")) return Identifier::NAMED_OBJECT;
-    if (str.starts_with("s ")) return Identifier::SMOOTH_SHADING;
-    if (str.starts_with("mtllib ")) return Identifier::MATERIAL_LIB;
-    if (str.starts_with("usemtl ")) return Identifier::USE_MATERIAL;
-    if (str.starts_with("# ")) return Identifier::COMMENT;
-    if (str.empty())
-        return Identifier::BLANK; // we trim before this call so it will always be empty
-
-    return Identifier::UNKNOWN;
+    m_config.triangulate = b;
 }
 
-std::string OBJLoader::toString(const Identifier id) const
+void PLYLoader::setExecutor(std::shared_ptr<Executor> executor)
 {
-    switch (id) {
-    case Identifier::POSITION:
-        return "v";
-    case Identifier::NORMAL:
-        return "vn";
-    case Identifier::UV:
-        return "vt";
-    case Identifier::FACE:
-        return "f";
-    case Identifier::GROUP:
-        return "g";
-    case Identifier::NAMED_OBJECT:
-        return "o";
-    case Identifier::SMOOTH_SHADING:
-        return "s";
-    case Identifier::MATERIAL_LIB:
-        return "mtllib";
-    case Identifier::USE_MATERIAL:
-        return "usemtl";
-    case Identifier::COMMENT:
-        return "#";
-    case Identifier::BLANK:
-        return "";
-    case Identifier::UNKNOWN:
-    default:
-        return "UNKNOWN";
-    }
+    m_executor = std::move(executor);
 }
 
-size_t OBJLoader::calculateIndex(const int index, const IndexType type) const
+void PLYLoader::setReclaimer(std::shared_ptr<Reclaimer> reclaimer)
 {
-    // TODO: handle invalid negative indices here as well as positve indieces
-    if (index > 0) return index - 1;
+    m_reclaimer = std::move(reclaimer);
+}
 
-    switch (type) {
-    case IndexType::POSITION:
-        m_positions.size() - abs(index);
-        break;
-    case IndexType::NORMAL:
-        m_normals.size() - abs(index);
-        break;
-    case IndexType::UV:
-        m_textureUVs.size() - abs(index);
-        break;
-    case IndexType::COLOR:
-        m_colors.size() - abs(index);
-        break;
-    case IndexType::FACE:
-        m_positions.size() - abs(index);
-        break;
-    default:
-        // can never happen
-        assert(false);
-    }
-    // can never happen
-    assert(false);
+void PLYLoader::setTransform(const Mat4& transform)
+{
+    m_config.transform.set(transform);
 }
 
-void OBJLoader::pushFace(const Face& face)
+void PLYLoader::setFlipUVs(const bool b)
 {
-    assert(!m_meshes.empty());
-    m_meshes.back().faces.push_back(face);
+    m_config.transform.flipUVs = b;
 }
 
-void OBJLoader::pushFaces(const std::vector<Face>& faces)
+bool PLYLoader::existsError() const
 {
-    assert(!m_meshes.empty());
-    for (const auto& face : faces) {
-        m_meshes.back().faces.push_back(face);
-    }
+    return m_logger->existsError();
 }
 
-std::vector<Face> OBJLoader::triangulate(const Face& face) const
+bool PLYLoader::existsWarning() const
 {
-    // TODO: add support for more than 3 or 4 vertices. actual algorithm would be cool :D
-    assert(m_config.triangulate);
+    return m_logger->existsWarning();
+}
 
-    // already a tri
-    if (face.numVertices() == 3) { return { face }; }
-    if (face.numVertices() != 4) {
-        throw std::runtime_error("Currently only quads and tris are supported");
-    }
+std::vector<std::string> PLYLoader::getInfos() const
+{
+    return m_logger->getInfos();
+}
 
-    Face f1{};
-    Face f2{};
-    // we turn p1 p2 p3 p4 into p1 p2 p3 + p1 p3 p4
-    constexpr int indices1[] = { 0, 1, 2 };
-    constexpr int indices2[] = { 0, 2, 3 };
-    for (const int i : indices1) {
-        f1.positionIndices.push_back(face.positionIndices[i]);
-        if (!face.normalIndices.empty()) f1.normalIndices.push_back(face.normalIndices[i]);
-        if (!face.colorIndices.empty()) f1.colorIndices.push_back(face.colorIndices[i]);
-        if (!face.uvIndices.empty()) f1.uvIndices.push_back(face.uvIndices[i]);
-    }
-    for (const int i : indices2) {
-        f2.positionIndices.push_back(face.positionIndices[i]);
-        if (!face.normalIndices.empty()) f2.normalIndices.push_back(face.normalIndices[i]);
-        if (!face.colorIndices.empty()) f2.colorIndices.push_back(face.colorIndices[i]);
-        if (!face.uvIndices.empty()) f2.uvIndices.push_back(face.uvIndices[i]);
-    }
+std::vector<std::string> PLYLoader::getErrors() const
+{
+    return m_logger->getErrors();
+}
 
-    return { f1, f2 };
+std::vector<std::string> PLYLoader::getWarnings() const
+{
+    return m_logger->getWarnings();
 }
 
-void OBJLoader::shrink()
+//--------------------------------------------------
+// MARK: Scanning
+//--------------------------------------------------
+
+namespace detail
 {
-    m_positions.shrink_to_fit();
-    m_normals.shrink_to_fit();
-    m_textureUVs.shrink_to_fit();
-    m_colors.shrink_to_fit();
-    m_images.shrink_to_fit();
-    m_materials.shrink_to_fit();
-    m_meshes.shrink_to_fit();
-    for (auto& mesh : m_meshes) {
-        mesh.faces.shrink_to_fit();
+constexpr size_t SCAN_CHUNK_SIZE = 1 << 20;
+
+inline const char* findNewline(const char* begin, const char* end)
+{
+#ifdef SOBJ_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - begin >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const int mask      = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        if (mask) return begin + std::countr_zero(static_cast<unsigned>(mask));
+        begin += 16;
     }
+#endif
+    const void* found = std::memchr(begin, '\n', end - begin);
+    return found ? static_cast<const char*>(found) : end;
 }
 
-void OBJLoader::makeGroupAnonym()
+/// @brief Calls fn with every trimmed line of the file, reading it in large chunks.
+template <typename Fn> bool forEachLine(const std::string& filePath, Fn&& fn)
 {
-    static size_t groupID = 0;
-    assert(!m_meshes.empty());
-    // only create new group if current group is not empty
-    if (m_meshes.back().faces.empty()) return;
+    std::ifstream file{ filePath, std::ios::binary };
+    if (!file.is_open()) return false;
 
-    std::string name{};
-    name = detail::GROUP_NAME_PREFIX + std::to_string(groupID++);
+    std::vector<char> buffer(SCAN_CHUNK_SIZE);
+    size_t carry = 0;
+    while (file) {
+        // lines longer than the buffer make it grow
+        if (carry == buffer.size()) buffer.resize(buffer.size() * 2);
+        file.read(buffer.data() + carry, static_cast<std::streamsize>(buffer.size() - carry));
+        const size_t size = carry + static_cast<size_t>(file.gcount());
+
+        const char* begin = buffer.data();
+        const char* end   = buffer.data() + size;
+        for (const char* newline = findNewline(begin, end); newline != end;
+             newline             = findNewline(begin, end)) {
+            fn(trimmed({ begin, newline }));
+            begin = newline + 1;
+        }
 
-    m_meshes.push_back({});
-    m_meshes.back().name = name;
+        carry = end - begin;
+        std::memmove(buffer.data(), begin, carry);
+    }
+    if (carry > 0) fn(trimmed({ buffer.data(), carry }));
+
+    return true;
 }
 
-void OBJLoader::makeGroup(const std::string& name)
+inline void pushUnique(std::vector<std::string>& names, std::unordered_set<std::string>& seen,
+                       const std::string_view name)
 {
-    std::string name_ = name;
-    detail::trim(name_);
-    m_currentMeshName = name_;
+    if (name.empty()) return;
+    if (seen.emplace(name).second) names.emplace_back(name);
+}
+} // namespace detail
 
-    // always make a new group
-    m_meshes.push_back({});
-    m_meshes.back().name = name_;
+std::optional<OBJSummary> OBJLoader::scan(const std::string& filePath)
+{
+    detail::TraceScope trace{ "OBJLoader::scan" };
+    m_logger->clear();
+
+    if (!filePath.ends_with(".obj")) {
+        m_logger->error(std::format("The file {} does not have the .obj extension", filePath));
+        return std::nullopt;
+    }
+
+    const std::filesystem::path objPath = filePath;
+    const std::string workingDirectory  = objPath.parent_path().string() + "/";
+
+    OBJSummary summary{};
+    summary.name = detail::fileNameFromPath(filePath);
+    std::unordered_set<std::string> seenGroups{};
+    std::unordered_set<std::string> seenObjects{};
+    std::unordered_set<std::string> seenMaterials{};
+    std::unordered_set<std::string> seenLibraries{};
+    std::unordered_set<std::string> seenTextures{};
+
+    // the keyword alone decides what a line is, the rest is only read for names
+    const bool opened = detail::forEachLine(filePath, [&](std::string_view line) {
+        const std::string_view keyword = detail::nextToken(line);
+        const std::string_view rest    = detail::trimmed(line);
+        if (keyword == "v") summary.numPositions++;
+        else if (keyword == "vn") summary.numNormals++;
+        else if (keyword == "vt") summary.numUVs++;
+        else if (keyword == "f") summary.numFaces++;
+        else if (keyword == "g") {
+            for (auto name = detail::nextToken(line); !name.empty();
+                 name      = detail::nextToken(line)) {
+                detail::pushUnique(summary.groups, seenGroups, name);
+            }
+        } else if (keyword == "o") detail::pushUnique(summary.objects, seenObjects, rest);
+        else if (keyword == "usemtl") detail::pushUnique(summary.materials, seenMaterials, rest);
+        else if (keyword == "mtllib") {
+            detail::pushUnique(summary.materialLibraries, seenLibraries, rest);
+        }
+    });
+    if (!opened) {
+        m_logger->error(std::format("Could not open file {}", filePath));
+        return std::nullopt;
+    }
+
+    // texture paths are always the last token of a map_ line, options come before them
+    for (const auto& library : summary.materialLibraries) {
+        const bool found =
+            detail::forEachLine(workingDirectory + library, [&](const std::string_view line) {
+                if (!line.starts_with("map_")) return;
+                const size_t space = line.find_last_of(" \t");
+                if (space == std::string_view::npos) return;
+                detail::pushUnique(summary.textures, seenTextures, line.substr(space + 1));
+            });
+        if (!found) m_logger->warn(std::format("Could not open material library {}", library));
+    }
+
+    return summary;
 }
 
 //--------------------------------------------------
@@ -1176,6 +6184,31 @@ void OBJLoader::setShouldTriangulate(const bool b)
     m_config.triangulate = b;
 }
 
+void OBJLoader::setMeshCallback(MeshCallback callback)
+{
+    m_config.meshCallback = std::move(callback);
+}
+
+void OBJLoader::setExecutor(std::shared_ptr<Executor> executor)
+{
+    m_executor = std::move(executor);
+}
+
+void OBJLoader::setReclaimer(std::shared_ptr<Reclaimer> reclaimer)
+{
+    m_reclaimer = std::move(reclaimer);
+}
+
+void OBJLoader::setTransform(const Mat4& transform)
+{
+    m_config.transform.set(transform);
+}
+
+void OBJLoader::setFlipUVs(const bool b)
+{
+    m_config.transform.flipUVs = b;
+}
+
 //--------------------------------------------------
 // MARK: Logging
 //--------------------------------------------------
@@ -1207,49 +6240,58 @@ std::vector<std::string> OBJLoader::getWarnings() const
 
 bool sobjLogger::existsError() const
 {
+    std::lock_guard lock{ m_mutex };
     return !m_errors.empty();
 }
 
 bool sobjLogger::existsWarning() const
 {
+    std::lock_guard lock{ m_mutex };
     return !m_warnings.empty();
 }
 
 void sobjLogger::error(const std::string& msg)
 {
+    std::lock_guard lock{ m_mutex };
     err(msg);
     m_errors.push_back(msg);
 }
 
 void sobjLogger::warn(const std::string& msg)
 {
+    std::lock_guard lock{ m_mutex };
     wrn(msg);
     m_warnings.push_back(msg);
 }
 
 void sobjLogger::info(const std::string& msg)
 {
+    std::lock_guard lock{ m_mutex };
     nfo(msg);
     m_infos.push_back(msg);
 }
 
 std::vector<std::string> sobjLogger::getErrors()
 {
+    std::lock_guard lock{ m_mutex };
     return m_errors;
 }
 
 std::vector<std::string> sobjLogger::getWarnings()
 {
+    std::lock_guard lock{ m_mutex };
     return m_warnings;
 }
 
 std::vector<std::string> sobjLogger::getInfos()
 {
+    std::lock_guard lock{ m_mutex };
     return m_infos;
 }
 
 void sobjLogger::clear()
 {
+    std::lock_guard lock{ m_mutex };
     m_errors.clear();
     m_warnings.clear();
     m_infos.clear();
@@ -1258,3 +6300,296 @@ void sobjLogger::clear()
 #endif
 
 } // namespace sobj
+
+//--------------------------------------------------
+// MARK: C API
+//--------------------------------------------------
+
+#if defined(SOBJ_IMPLEMENTATION) && defined(SOBJ_C_API)
+#include "sobj_c.h"
+
+namespace sobj::detail
+{
+static_assert(sizeof(Vec3) == 3 * sizeof(float) && sizeof(Vec2) == 2 * sizeof(float));
+static_assert(sizeof(SmoothingRun) == sizeof(sobj_smoothing_run));
+
+/// @brief Index data of a mesh in contiguous arrays, see sobj_mesh.
+struct FlatFaces {
+    std::vector<uint32_t> faceOffsets{};
+    std::vector<uint32_t> positionIndices{};
+    std::vector<uint32_t> normalIndices{};
+    std::vector<uint32_t> uvIndices{};
+    std::vector<uint32_t> colorIndices{};
+};
+
+inline FlatFaces flattenFaces(const Mesh& mesh)
+{
+    FlatFaces flat{};
+    flat.faceOffsets.reserve(mesh.faces.size() + 1);
+    flat.faceOffsets.push_back(0);
+    for (const auto& face : mesh.faces) {
+        flat.positionIndices.insert(
+            flat.positionIndices.end(), face.positionIndices.begin(), face.positionIndices.end());
+        flat.faceOffsets.push_back(static_cast<uint32_t>(flat.positionIndices.size()));
+    }
+
+    const auto flatten = [&](std::vector<uint32_t> Face::* indices, std::vector<uint32_t>& out) {
+        const bool used = std::ranges::any_of(mesh.faces, [&](const Face& face) {
+            return !(face.*indices).empty();
+        });
+        if (!used) return;
+        out.reserve(flat.positionIndices.size());
+        for (const auto& face : mesh.faces) {
+            const auto& faceIndices = face.*indices;
+            if (faceIndices.empty()) {
+                out.insert(out.end(), face.numVertices(), NO_INDEX);
+            } else {
+                out.insert(out.end(), faceIndices.begin(), faceIndices.end());
+            }
+        }
+    };
+    flatten(&Face::normalIndices, flat.normalIndices);
+    flatten(&Face::uvIndices, flat.uvIndices);
+    flatten(&Face::colorIndices, flat.colorIndices);
+    return flat;
+}
+
+inline sobj_string cString(const std::string_view str)
+{
+    return { str.data(), str.size() };
+}
+
+inline sobj_index_view cIndices(const std::vector<uint32_t>& indices)
+{
+    return { indices.data(), indices.size() };
+}
+
+inline uint32_t cIndex(const std::optional<uint32_t>& index)
+{
+    return index.value_or(NO_INDEX);
+}
+
+inline int cVec3(const std::optional<Vec3>& vec, float (&out)[3])
+{
+    if (!vec) return 0;
+    out[0] = vec->x;
+    out[1] = vec->y;
+    out[2] = vec->z;
+    return 1;
+}
+
+inline int cFloat(const std::optional<float>& value, float& out)
+{
+    if (!value) return 0;
+    out = *value;
+    return 1;
+}
+} // namespace sobj::detail
+
+struct sobj_data {
+    sobj::OBJData data{};
+    // faces are flattened once after loading and the Face vectors are freed
+    std::vector<sobj::detail::FlatFaces> faces{};
+    bool succeeded = false;
+    // indexed by sobj_message_level
+    std::array<std::vector<std::string>, 3> messages{};
+};
+
+extern "C" {
+
+uint32_t sobj_api_version(void)
+{
+    return SOBJ_C_API_VERSION;
+}
+
+sobj_load_options sobj_default_load_options(void)
+{
+    return { 1, 0, nullptr };
+}
+
+sobj_data* sobj_load(const char* path, const sobj_load_options* options)
+{
+    // exceptions must not cross the C boundary. running out of memory returns null, anything
+    // else the loaders throw fails the load with the exception as an error message
+    try {
+        auto handle                    = std::make_unique<sobj_data>();
+        const sobj_load_options config = options ? *options : sobj_default_load_options();
+
+        const auto load = [&](auto& loader) {
+            loader.setShouldTriangulate(config.triangulate != 0);
+            loader.setFlipUVs(config.flip_uvs != 0);
+            if (config.transform) {
+                sobj::Mat4 transform{};
+                std::copy_n(config.transform, transform.values.size(), transform.values.begin());
+                loader.setTransform(transform);
+            }
+
+            std::optional<std::string> error = std::nullopt;
+            try {
+                handle->succeeded = loader.load(path);
+            } catch (const std::bad_alloc&) {
+                throw;
+            } catch (const std::exception& e) {
+                error = e.what();
+            } catch (...) {
+                error = "Unknown exception while loading";
+            }
+
+            handle->messages = { loader.getErrors(), loader.getWarnings(), loader.getInfos() };
+            if (error) {
+                handle->succeeded = false;
+                handle->messages[SOBJ_MESSAGE_ERROR].push_back(std::move(*error));
+            }
+            if (handle->succeeded) handle->data = loader.steal();
+        };
+
+        if (std::string_view{ path }.ends_with(".ply")) {
+            sobj::PLYLoader loader;
+            load(loader);
+        } else {
+            sobj::OBJLoader loader;
+            load(loader);
+        }
+
+        handle->faces.reserve(handle->data.meshes.size());
+        for (auto& mesh : handle->data.meshes) {
+            handle->faces.push_back(sobj::detail::flattenFaces(mesh));
+            mesh.faces = {};
+        }
+
+        return handle.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void sobj_free(sobj_data* data)
+{
+    delete data;
+}
+
+int sobj_succeeded(const sobj_data* data)
+{
+    return data->succeeded;
+}
+
+size_t sobj_num_messages(const sobj_data* data, const sobj_message_level level)
+{
+    return data->messages[level].size();
+}
+
+sobj_string sobj_message(const sobj_data* data, const sobj_message_level level,
+                         const size_t index)
+{
+    const auto& messages = data->messages[level];
+    if (index >= messages.size()) return { nullptr, 0 };
+    return sobj::detail::cString(messages[index]);
+}
+
+sobj_string sobj_file_name(const sobj_data* data)
+{
+    return sobj::detail::cString(data->data.name);
+}
+
+sobj_string sobj_name(const sobj_data* data, const uint32_t id)
+{
+    if (id >= data->data.names.size()) return { nullptr, 0 };
+    return sobj::detail::cString(data->data.names.view(id));
+}
+
+sobj_vec3_view sobj_positions(const sobj_data* data)
+{
+    const auto& positions = data->data.positions;
+    return { reinterpret_cast<const float*>(positions.data()), positions.size() };
+}
+
+sobj_vec3_view sobj_normals(const sobj_data* data)
+{
+    const auto& normals = data->data.normals;
+    return { reinterpret_cast<const float*>(normals.data()), normals.size() };
+}
+
+sobj_vec2_view sobj_texture_uvs(const sobj_data* data)
+{
+    const auto& uvs = data->data.textureUVs;
+    return { reinterpret_cast<const float*>(uvs.data()), uvs.size() };
+}
+
+sobj_vec3_view sobj_colors(const sobj_data* data)
+{
+    const auto& colors = data->data.colors;
+    return { reinterpret_cast<const float*>(colors.data()), colors.size() };
+}
+
+size_t sobj_num_meshes(const sobj_data* data)
+{
+    return data->data.meshes.size();
+}
+
+int sobj_get_mesh(const sobj_data* data, const size_t index, sobj_mesh* out)
+{
+    if (index >= data->data.meshes.size()) return 0;
+    const sobj::Mesh& mesh             = data->data.meshes[index];
+    const sobj::detail::FlatFaces& flat = data->faces[index];
+
+    out->name             = sobj::detail::cString(data->data.names.view(mesh.name));
+    out->groups           = { mesh.groups.data(), mesh.groups.size() };
+    out->material_index   = sobj::detail::cIndex(mesh.materialIndex);
+    out->unified_indices  = mesh.unifiedIndices;
+    out->num_faces        = flat.faceOffsets.size() - 1;
+    out->face_offsets     = sobj::detail::cIndices(flat.faceOffsets);
+    out->position_indices = sobj::detail::cIndices(flat.positionIndices);
+    out->normal_indices   = sobj::detail::cIndices(flat.normalIndices);
+    out->uv_indices       = sobj::detail::cIndices(flat.uvIndices);
+    out->color_indices    = sobj::detail::cIndices(flat.colorIndices);
+    out->smoothing_groups = {
+        reinterpret_cast<const sobj_smoothing_run*>(mesh.smoothingGroups.data()),
+        mesh.smoothingGroups.size(),
+    };
+    return 1;
+}
+
+size_t sobj_num_materials(const sobj_data* data)
+{
+    return data->data.materials.size();
+}
+
+int sobj_get_material(const sobj_data* data, const size_t index, sobj_material* out)
+{
+    if (index >= data->data.materials.size()) return 0;
+    const sobj::Material& material = data->data.materials[index];
+
+    *out                     = {};
+    out->name                = sobj::detail::cString(data->data.names.view(material.name));
+    out->ambient_map_index   = sobj::detail::cIndex(material.ambientMapIndex);
+    out->diffuse_map_index   = sobj::detail::cIndex(material.diffuseMapIndex);
+    out->specular_map_index  = sobj::detail::cIndex(material.specularMapIndex);
+    out->roughness_map_index = sobj::detail::cIndex(material.roughnessMapIndex);
+    out->alpha_map_index     = sobj::detail::cIndex(material.alphaMapIndex);
+    out->has_ambient         = sobj::detail::cVec3(material.ambient, out->ambient);
+    out->has_diffuse         = sobj::detail::cVec3(material.diffuse, out->diffuse);
+    out->has_specular        = sobj::detail::cVec3(material.specular, out->specular);
+    out->has_roughness       = sobj::detail::cFloat(material.roughness, out->roughness);
+    out->has_alpha           = sobj::detail::cFloat(material.alpha, out->alpha);
+    return 1;
+}
+
+size_t sobj_num_images(const sobj_data* data)
+{
+    return data->data.images.size();
+}
+
+int sobj_get_image(const sobj_data* data, const size_t index, sobj_image* out)
+{
+    if (index >= data->data.images.size()) return 0;
+    const sobj::ImageData& image = data->data.images[index];
+
+    out->name     = sobj::detail::cString(data->data.names.view(image.name));
+    out->bytes    = { image.bytes.data(), image.bytes.size() };
+    out->width    = image.width;
+    out->height   = image.height;
+    out->channels = image.channels;
+    return 1;
+}
+} // extern "C"
+#endif
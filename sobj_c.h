@@ -0,0 +1,153 @@
+/* C interface to sobj for bindings in other languages.
+ *
+ * The implementation is part of sobj.hpp, compile it in exactly one C++ translation unit
+ * with both SOBJ_IMPLEMENTATION and SOBJ_C_API defined.
+ *
+ * Everything loaded lives in a sobj_data handle. All views handed out point straight into
+ * it and stay valid until sobj_free is called on that handle, nothing is copied. Strings are
+ * not null terminated. Views of empty arrays may have a null data pointer. */
+#ifndef SOBJ_C_H
+#define SOBJ_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bumped whenever a struct or function signature changes */
+#define SOBJ_C_API_VERSION 1
+/* used for optional indices such as the material of a mesh */
+#define SOBJ_NO_INDEX UINT32_MAX
+
+typedef struct sobj_data sobj_data;
+
+typedef enum sobj_message_level {
+    SOBJ_MESSAGE_ERROR   = 0,
+    SOBJ_MESSAGE_WARNING = 1,
+    SOBJ_MESSAGE_INFO    = 2,
+} sobj_message_level;
+
+typedef struct sobj_string {
+    const char* data;
+    size_t length;
+} sobj_string;
+
+/* count elements of 3 (or 2) tightly packed floats */
+typedef struct sobj_vec3_view {
+    const float* data;
+    size_t count;
+} sobj_vec3_view;
+
+typedef struct sobj_vec2_view {
+    const float* data;
+    size_t count;
+} sobj_vec2_view;
+
+typedef struct sobj_index_view {
+    const uint32_t* data;
+    size_t count;
+} sobj_index_view;
+
+typedef struct sobj_byte_view {
+    const unsigned char* data;
+    size_t count;
+} sobj_byte_view;
+
+typedef struct sobj_smoothing_run {
+    uint32_t first_face;
+    uint32_t group;
+} sobj_smoothing_run;
+
+typedef struct sobj_smoothing_view {
+    const sobj_smoothing_run* data;
+    size_t count;
+} sobj_smoothing_view;
+
+typedef struct sobj_load_options {
+    int triangulate;
+    int flip_uvs;
+    /* column major 4x4 matrix applied to positions, or null */
+    const float* transform;
+} sobj_load_options;
+
+/* Face i of a mesh uses the entries [face_offsets[i], face_offsets[i + 1]) of the index
+ * views. Attributes a face does not have are SOBJ_NO_INDEX, index views no face of the mesh
+ * uses are empty. */
+typedef struct sobj_mesh {
+    sobj_string name;
+    /* ids of every name of the g line, see sobj_name */
+    sobj_index_view groups;
+    uint32_t material_index;
+    int unified_indices;
+    size_t num_faces;
+    sobj_index_view face_offsets;
+    sobj_index_view position_indices;
+    sobj_index_view normal_indices;
+    sobj_index_view uv_indices;
+    sobj_index_view color_indices;
+    sobj_smoothing_view smoothing_groups;
+} sobj_mesh;
+
+/* colors and scalars are only meaningful if the matching has_ flag is set */
+typedef struct sobj_material {
+    sobj_string name;
+    uint32_t ambient_map_index;
+    uint32_t diffuse_map_index;
+    uint32_t specular_map_index;
+    uint32_t roughness_map_index;
+    uint32_t alpha_map_index;
+    int has_ambient;
+    int has_diffuse;
+    int has_specular;
+    int has_roughness;
+    int has_alpha;
+    float ambient[3];
+    float diffuse[3];
+    float specular[3];
+    float roughness;
+    float alpha;
+} sobj_material;
+
+typedef struct sobj_image {
+    sobj_string name;
+    sobj_byte_view bytes;
+    int width;
+    int height;
+    int channels;
+} sobj_image;
+
+uint32_t sobj_api_version(void);
+sobj_load_options sobj_default_load_options(void);
+
+/* Loads an obj file, or a ply file if the path ends in .ply. options may be null. Always
+ * returns a handle unless memory runs out, check sobj_succeeded and the error messages. */
+sobj_data* sobj_load(const char* path, const sobj_load_options* options);
+void sobj_free(sobj_data* data);
+
+int sobj_succeeded(const sobj_data* data);
+size_t sobj_num_messages(const sobj_data* data, sobj_message_level level);
+sobj_string sobj_message(const sobj_data* data, sobj_message_level level, size_t index);
+
+sobj_string sobj_file_name(const sobj_data* data);
+/* name of a mesh, group, material or image by its id */
+sobj_string sobj_name(const sobj_data* data, uint32_t id);
+sobj_vec3_view sobj_positions(const sobj_data* data);
+sobj_vec3_view sobj_normals(const sobj_data* data);
+sobj_vec2_view sobj_texture_uvs(const sobj_data* data);
+sobj_vec3_view sobj_colors(const sobj_data* data);
+
+/* the getters below return 0 and leave out untouched if index is out of range */
+size_t sobj_num_meshes(const sobj_data* data);
+int sobj_get_mesh(const sobj_data* data, size_t index, sobj_mesh* out);
+size_t sobj_num_materials(const sobj_data* data);
+int sobj_get_material(const sobj_data* data, size_t index, sobj_material* out);
+size_t sobj_num_images(const sobj_data* data);
+int sobj_get_image(const sobj_data* data, size_t index, sobj_image* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif